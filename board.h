@@ -9,37 +9,44 @@
 #include <vector>
 #include <tuple>
 #include <string>
+#include <cstdint>
 
 #include "cell.h"
-#include "randomizer.h"
+#include "topology.h"
+#include "board_logic.h"
 
 /**
  * @class Board
  * @brief A class holding current state of the game, checks win, loose conditions.
+ *
+ * @details Cells are stored row by row, every walk over the neighbours of a cell uses the
+ * precomputed `Topology` table, so the same code plays rectangular, torus and hexagonal boards.
+ * The rules of the game come from `BoardLogic`, shared with `FixedBoard`.
 */
 
-class Board {
+class Board : public BoardLogic<Board> {
 private:
-    std::vector<std::vector<Cell>> board;
+    friend class BoardLogic<Board>;
+    std::vector<Cell> board;
     int width;
     int height;
-    int bomb_amount;
-    int first_x;
-    int first_y;
-    RandomNumberGenerator rng;
+    Topology topology;
+    Cell* cell_data() { return board.data(); }
+    const Cell* cell_data() const { return board.data(); }
+    int index(int row, int column) const { return row * width + column; }
+    int row_of(int index) const { return index / width; }
+    int column_of(int index) const { return index % width; }
+    int position(int index) const { return index; }
+    Topology::Neighbours neighbours(int index) const { return topology.neighbours(index); }
+    bool are_neighbours(int index, int other) const { return topology.are_neighbours(index, other); }
 public:
-    Board(int w, int h, int bombs, int x, int y);
-    std::vector<std::vector<Cell>> create_board();
-    void count_bombs(int x, int y);
-    void place_bombs();
+    Board(int w, int h, int bombs, int x, int y, Shape shape = Shape::Rectangle);
+    std::vector<Cell> create_board();
     void update_board();
-    bool handle_first_mode(Board& board, Cell& cell, int row, int column);
-    void reveal_around(int row, int column);
-    void handle_second_mode(Cell& cell);
-    bool handle_win_condition();
-    void handle_lose_condition();
-    const std::vector<std::vector<Cell>>& get_board() const;
-    Cell& get_cell(int row, int col);
+    const std::vector<Cell>& get_board() const;
+    int get_width() const;
+    int get_height() const;
+    Shape get_shape() const;
 };
 
 #endif //BOARD_H
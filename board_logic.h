@@ -0,0 +1,499 @@
+/**
+ * @file board_logic.h
+ * @brief Game rules shared by all board types.
+ */
+
+#ifndef BOARD_LOGIC_H
+#define BOARD_LOGIC_H
+
+#include <cstdint>
+#include <vector>
+
+#include "cell.h"
+#include "randomizer.h"
+#include "topology.h"
+#include "fenwick_tree.h"
+#include "summed_area_table.h"
+
+/**
+ * @class BoardLogic
+ * @brief The rules of the game written once for every board type.
+ *
+ * @details The class uses the curiously recurring template pattern: the derived board owns the cells and
+ * decides how they are stored and which cells are neighbours, the rules only go through these calls, which
+ * are inlined into the derived board:
+ *  - `Cell* cell_data()` – the cells, indexed by storage index,
+ *  - `int index(int row, int column) const` – storage index of a cell,
+ *  - `int row_of(int index) const`, `int column_of(int index) const` – the position of a storage index,
+ *  - `int position(int index) const` – the unpadded index `row * width + column` of a storage index,
+ *  - `Topology::Neighbours neighbours(int index) const` – storage indices of the neighbours,
+ *  - `bool are_neighbours(int index, int other) const`,
+ *  - `int get_width() const`, `int get_height() const`.
+ *
+ * Changed cells are recorded by `position` whatever the storage. The bombs, flags and
+ * covered cells of any rectangle can be counted without scanning it: the bombs are kept in a summed-area
+ * table built once the bombs are placed (O(1) per query), the flags and covered cells in Fenwick trees
+ * (O(log width * log height)). Flags update their tree right away. Reveals come in floods of thousands of
+ * cells, so they only decrement a plain counter used by the win condition and are brought into the tree
+ * when the next rectangle query needs it, one by one or by rebuilding the tree when there are many.
+ *
+ * @tparam Derived The board type, `Board` or `FixedBoard`.
+ */
+
+template <typename Derived>
+class BoardLogic {
+private:
+    SummedAreaTable mine_counts;
+    FenwickTree2D flag_counts;
+    mutable FenwickTree2D covered_counts;
+    mutable std::vector<int> unsynced;
+    mutable bool covered_stale = false;
+    std::size_t unsynced_limit = 0;
+    int covered_amount = 0;
+    int marked_mines = 0;
+    std::vector<int> pending;
+    Derived& derived() { return static_cast<Derived&>(*this); }
+    const Derived& derived() const { return static_cast<const Derived&>(*this); }
+    Cell& cell_at(int index) { return derived().cell_data()[index]; }
+    void record(int index);
+    void reveal_cell(int index);
+    void toggle_flag(int index);
+    void update_mine_counts();
+    void sync_covered() const;
+protected:
+    int bomb_amount;
+    int first_x;
+    int first_y;
+    std::vector<int> changed;
+    RandomNumberGenerator rng;
+    BoardLogic(int bombs, int x, int y) : bomb_amount(bombs), first_x(x), first_y(y) {}
+    void reset_counts();
+public:
+    void count_bombs(int x, int y);
+    void place_bombs(bool keep_first_safe = true);
+    void relocate_bombs(int x, int y);
+    void place_bombs_from(const std::uint8_t* mines);
+    bool handle_first_mode(Derived& board, Cell& cell, int row, int column);
+    void reveal_around(int row, int column);
+    void handle_second_mode(Cell& cell);
+    bool handle_third_mode(int row, int column);
+    bool handle_win_condition();
+    void handle_lose_condition();
+    Cell& get_cell(int row, int col) { return cell_at(derived().index(row, col)); }
+    const Cell& get_cell(int row, int col) const { return derived().cell_data()[derived().index(row, col)]; }
+    const std::vector<int>& get_changed() const { return changed; }
+    void clear_changed() { changed.clear(); }
+    int count_mines(int top, int left, int bottom, int right) const;
+    int count_flags(int top, int left, int bottom, int right) const;
+    int count_covered(int top, int left, int bottom, int right) const;
+};
+
+/**
+ * @brief Builds the counts of a new board, called by the derived constructor once the cells exist.
+ */
+
+template <typename Derived>
+void BoardLogic<Derived>::reset_counts() {
+    update_mine_counts();
+    flag_counts.build(derived().get_width(), derived().get_height(), [](int, int) { return false; });
+    covered_counts.build(derived().get_width(), derived().get_height(), [](int, int) { return true; });
+    covered_amount = derived().get_width() * derived().get_height();
+    unsynced_limit = static_cast<std::size_t>(covered_amount / 64);
+    unsynced.clear();
+    covered_stale = false;
+}
+
+/**
+ * @brief Records a changed cell.
+ *
+ * @param index Storage index of the cell.
+ */
+
+template <typename Derived>
+void BoardLogic<Derived>::record(int index) {
+    changed.push_back(derived().position(index));
+}
+
+/**
+ * @brief Reveals a cell and updates the count of covered cells.
+ *
+ * The tree of covered cells is only told later by `sync_covered`. Once more cells are waiting than
+ * a rebuild of the tree costs, they are dropped and the tree is rebuilt from the cells instead.
+ *
+ * @param index Storage index of a covered cell.
+ */
+
+template <typename Derived>
+void BoardLogic<Derived>::reveal_cell(int index) {
+    cell_at(index).reveal();
+    record(index);
+    covered_amount--;
+    if (covered_stale) {
+        return;
+    }
+    if (unsynced.size() < unsynced_limit) {
+        unsynced.push_back(index);
+    } else {
+        unsynced.clear();
+        covered_stale = true;
+    }
+}
+
+/**
+ * @brief Brings the tree of covered cells up to date with the reveals since the last query.
+ */
+
+template <typename Derived>
+void BoardLogic<Derived>::sync_covered() const {
+    if (covered_stale) {
+        covered_counts.build(derived().get_width(), derived().get_height(),
+                             [this](int row, int column) { return !get_cell(row, column).get_is_revealed(); });
+        covered_stale = false;
+    }
+    for (int index : unsynced) {
+        covered_counts.add(derived().row_of(index), derived().column_of(index), -1);
+    }
+    unsynced.clear();
+}
+
+/**
+ * @brief Flags or unflags a cell and updates the counts of flags.
+ *
+ * @param index Storage index of the cell.
+ */
+
+template <typename Derived>
+void BoardLogic<Derived>::toggle_flag(int index) {
+    Cell& cell = cell_at(index);
+    cell.flag_bomb();
+    record(index);
+    const int delta = cell.get_is_marked() ? 1 : -1;
+    flag_counts.add(derived().row_of(index), derived().column_of(index), delta);
+    if (cell.get_is_bomb()) {
+        marked_mines += delta;
+    }
+}
+
+/**
+ * @brief Builds the summed-area table of the bombs, called whenever the bombs are moved.
+ */
+
+template <typename Derived>
+void BoardLogic<Derived>::update_mine_counts() {
+    const int width = derived().get_width();
+    const int height = derived().get_height();
+    mine_counts.build(width, height, [this](int row, int column) { return get_cell(row, column).get_is_bomb(); });
+    marked_mines = 0;
+    for (int row = 0; row < height; ++row) {
+        for (int column = 0; column < width; ++column) {
+            marked_mines += get_cell(row, column).get_is_bomb() && get_cell(row, column).get_is_marked();
+        }
+    }
+}
+
+/**
+ * @brief Counts the number of bombs around a specific cell.
+ *
+ * @param x Row of the cell.
+ * @param y Column of the cell.
+ */
+
+template <typename Derived>
+void BoardLogic<Derived>::count_bombs(int x, int y) {
+    const int center = derived().index(x, y);
+    int bombs = 0;
+    for (int neighbour : derived().neighbours(center)) {
+        bombs += cell_at(neighbour).get_is_bomb();
+    }
+    while (bombs--) {
+        cell_at(center).update_counter();
+    }
+}
+
+/**
+ * @brief Places bombs randomly on the board.
+ *
+ * Ensures that bombs are not placed on or around the first cell chosen by the player,
+ * unless the board is generated before the first move is known.
+ *
+ * @param keep_first_safe If false the bombs can be placed anywhere, `relocate_bombs` then clears the first move.
+ */
+
+template <typename Derived>
+void BoardLogic<Derived>::place_bombs(bool keep_first_safe) {
+    const int first = derived().index(first_x, first_y);
+    int placed = 0;
+    while (placed < bomb_amount) {
+        int row = rng.get_random_number(0, derived().get_height() - 1);
+        int column = rng.get_random_number(0, derived().get_width() - 1);
+        int cell = derived().index(row, column);
+        if (keep_first_safe && (cell == first || derived().are_neighbours(first, cell))) {
+            continue;
+        }
+        if (!cell_at(cell).get_is_bomb()) {
+            cell_at(cell).mark_as_bomb();
+            placed++;
+        }
+    }
+    update_mine_counts();
+}
+
+/**
+ * @brief Moves the bombs out of the first move and its surroundings.
+ *
+ * Used on a board generated in the background before the first move was known. Every bomb
+ * found around the first move is moved to a random free cell outside of that area and only
+ * the counters around the old and the new position are updated. The board ends up with the
+ * same distribution as one generated by `place_bombs` after the first move.
+ *
+ * @param x Row of the first move.
+ * @param y Column of the first move.
+ */
+
+template <typename Derived>
+void BoardLogic<Derived>::relocate_bombs(int x, int y) {
+    first_x = x;
+    first_y = y;
+    auto update_around = [this](int cell, bool add) {
+        for (int neighbour : derived().neighbours(cell)) {
+            if (add) {
+                cell_at(neighbour).update_counter();
+            } else {
+                cell_at(neighbour).decrease_counter();
+            }
+        }
+    };
+    auto move_out = [this, &update_around](int cell) {
+        if (cell_at(cell).get_is_bomb()) {
+            cell_at(cell).unmark_as_bomb();
+            update_around(cell, false);
+            return 1;
+        }
+        return 0;
+    };
+    const int first = derived().index(x, y);
+    int moved = move_out(first);
+    for (int neighbour : derived().neighbours(first)) {
+        moved += move_out(neighbour);
+    }
+    while (moved) {
+        int row = rng.get_random_number(0, derived().get_height() - 1);
+        int column = rng.get_random_number(0, derived().get_width() - 1);
+        int cell = derived().index(row, column);
+        if (cell != first && !derived().are_neighbours(first, cell) && !cell_at(cell).get_is_bomb()) {
+            cell_at(cell).mark_as_bomb();
+            update_around(cell, true);
+            moved--;
+        }
+    }
+    update_mine_counts();
+}
+
+/**
+ * @brief Places bombs from a pre-generated mine bitmap.
+ *
+ * Used instead of `place_bombs` when the board is taken from the `PuzzleBank`.
+ *
+ * @param mines Mine bitmap, one bit per cell row by row.
+ */
+
+template <typename Derived>
+void BoardLogic<Derived>::place_bombs_from(const std::uint8_t* mines) {
+    const int width = derived().get_width();
+    for (int i = 0; i < width * derived().get_height(); ++i) {
+        if ((mines[i >> 3] >> (i & 7)) & 1) {
+            get_cell(i / width, i % width).mark_as_bomb();
+        }
+    }
+    update_mine_counts();
+}
+
+/**
+ * @brief Handles the first mode of cell interaction.
+ *
+ * Reveals a cell and its surroundings if it is not a bomb or marked. Ends the game if a bomb is revealed.
+ *
+ * @param board Reference to the board.
+ * @param cell Reference to the cell user interacts with.
+ * @param row Row of the cell.
+ * @param column Column of the cell.
+ *
+ * @return True if the game continues, false if the game is lost.
+ */
+
+template <typename Derived>
+bool BoardLogic<Derived>::handle_first_mode(Derived& board, Cell& cell, int row, int column) {
+    if (cell.get_is_marked()) {
+        toggle_flag(derived().index(row, column));
+    }
+    if (!cell.get_is_revealed() && !cell.get_is_bomb()) {
+        reveal_cell(derived().index(row, column));
+        board.reveal_around(row, column);
+    } else if (cell.get_is_bomb()) {
+        handle_lose_condition();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Flags a cell as a bomb if it is not revealed yet.
+ *
+ * @param cell Reference to the cell being interacted with.
+ */
+
+template <typename Derived>
+void BoardLogic<Derived>::handle_second_mode(Cell& cell) {
+    if (!cell.get_is_revealed()) {
+        toggle_flag(static_cast<int>(&cell - derived().cell_data()));
+    }
+}
+
+/**
+ * @brief Handles the third mode of cell interaction (chord).
+ *
+ * If the cell is a revealed number and the amount of flags around it matches that number,
+ * all unflagged neighbours are revealed.
+ *
+ * @param row Row of the cell.
+ * @param column Column of the cell.
+ *
+ * @return True if the game continues, false if the game is lost.
+ */
+
+template <typename Derived>
+bool BoardLogic<Derived>::handle_third_mode(int row, int column) {
+    const int center = derived().index(row, column);
+    if (!cell_at(center).get_is_revealed() || !cell_at(center).get_bombs_around()) {
+        return true;
+    }
+    int flags = 0;
+    for (int neighbour : derived().neighbours(center)) {
+        flags += cell_at(neighbour).get_is_marked();
+    }
+    if (flags != cell_at(center).get_bombs_around()) {
+        return true;
+    }
+    bool running = true;
+    for (int neighbour : derived().neighbours(center)) {
+        Cell& cell = cell_at(neighbour);
+        if (!cell.get_is_marked() && !cell.get_is_revealed()) {
+            running = handle_first_mode(derived(), cell, derived().row_of(neighbour), derived().column_of(neighbour))
+                      && running;
+        }
+    }
+    return running;
+}
+
+/**
+ * @brief Reveals the cells around a specified cell.
+ *
+ * Keeps revealing the neighbours of cells which do not have bombs around them. The cells
+ * still to be expanded are kept on a stack reused between calls, so large empty areas
+ * neither recurse deeply nor allocate on every reveal.
+ *
+ * @param row Row of the cell.
+ * @param column Column of the cell.
+ */
+
+template <typename Derived>
+void BoardLogic<Derived>::reveal_around(int row, int column) {
+    const int start = derived().index(row, column);
+    if (cell_at(start).get_bombs_around()) {
+        return;
+    }
+    pending.assign(1, start);
+    while (!pending.empty()) {
+        const int center = pending.back();
+        pending.pop_back();
+        for (int neighbour : derived().neighbours(center)) {
+            Cell& next = cell_at(neighbour);
+            if (!next.get_is_revealed() && !next.get_is_bomb()) {
+                reveal_cell(neighbour);
+                if (next.get_bombs_around() == 0) {
+                    pending.push_back(neighbour);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Counts the bombs in a rectangle in O(1).
+ *
+ * Meant for hints and for pruning in generators and solvers, the parts of the rectangle
+ * outside of the board are ignored.
+ *
+ * @param top First row of the rectangle.
+ * @param left First column of the rectangle.
+ * @param bottom Last row of the rectangle.
+ * @param right Last column of the rectangle.
+ * @return Number of bombs.
+ */
+
+template <typename Derived>
+int BoardLogic<Derived>::count_mines(int top, int left, int bottom, int right) const {
+    return mine_counts.count(top, left, bottom, right);
+}
+
+/**
+ * @brief Counts the flagged cells in a rectangle in O(log width * log height).
+ *
+ * @return Number of flags, see `count_mines` for the parameters.
+ */
+
+template <typename Derived>
+int BoardLogic<Derived>::count_flags(int top, int left, int bottom, int right) const {
+    return flag_counts.count(top, left, bottom, right);
+}
+
+/**
+ * @brief Counts the covered (not revealed) cells in a rectangle in O(log width * log height).
+ *
+ * Flagged cells are covered as well. The reveals since the last query are applied first.
+ *
+ * @return Number of covered cells, see `count_mines` for the parameters.
+ */
+
+template <typename Derived>
+int BoardLogic<Derived>::count_covered(int top, int left, int bottom, int right) const {
+    sync_covered();
+    return covered_counts.count(top, left, bottom, right);
+}
+
+/**
+ * @brief Checks if the win condition is met.
+ *
+ * Bombs stay covered while the game goes on, so all other cells are revealed once the number of
+ * covered cells equals the number of bombs. Answered from the counters without scanning the board.
+ *
+ * @return True if there are still cells to be revealed or bombs to be marked, false if the game is won.
+ */
+
+template <typename Derived>
+bool BoardLogic<Derived>::handle_win_condition() {
+    const int mines = mine_counts.total();
+    return covered_amount != mines || marked_mines != mines;
+}
+
+/**
+ * @brief Reveals all cells on the board when the game is lost.
+ */
+
+template <typename Derived>
+void BoardLogic<Derived>::handle_lose_condition() {
+    const int width = derived().get_width();
+    const int height = derived().get_height();
+    for (int row = 0; row < height; ++row) {
+        for (int column = 0; column < width; ++column) {
+            get_cell(row, column).reveal();
+            changed.push_back(row * width + column);
+        }
+    }
+    covered_counts.build(width, height, [](int, int) { return false; });
+    covered_amount = 0;
+    unsynced.clear();
+    covered_stale = false;
+}
+
+#endif //BOARD_LOGIC_H
@@ -0,0 +1,177 @@
+/**
+ * @file bot.cpp
+ * @brief Implementation of `Bot` class and related functionalities.
+ */
+
+#include <algorithm>
+
+#include "bot.h"
+
+/**
+ * @brief Constructs a new Bot object.
+ *
+ * @param board Board shared with the other players.
+ * @param id Index of the bot used for its score, 0 is reserved for the human player.
+ */
+
+Bot::Bot(SharedBoard& board, int id)
+    : board(board), id(id), known_bombs(board.get_width() * board.get_height(), false) {}
+
+/**
+ * @brief Looks for a revealed number whose bombs are all known and which still has cells to reveal around.
+ *
+ * Numbers with as many covered neighbours as bombs around mark these neighbours as known bombs on the way.
+ * The board is scanned again after new bombs have been marked, as they may satisfy numbers already passed.
+ *
+ * @return true if such a number has been found, its position is stored in `row` and `column`.
+ */
+
+bool Bot::find_satisfied(int& row, int& column) {
+    const int width = board.get_width();
+    const int height = board.get_height();
+    const int size = width * height;
+    bool marked = true;
+    while (marked) {
+        marked = false;
+        const int start = rng.get_random_number(0, size - 1);
+        for (int i = 0; i < size; ++i) {
+            const int index = (start + i) % size;
+            row = index / width;
+            column = index % width;
+            const int bombs = board.get_bombs_around(row, column);
+            if (!bombs || !board.is_revealed(row, column)) {
+                continue;
+            }
+            int covered = 0;
+            int known = 0;
+            int open = 0;
+            for (int x = std::max(0, row - 1); x < std::min(height, row + 2); ++x) {
+                for (int y = std::max(0, column - 1); y < std::min(width, column + 2); ++y) {
+                    if (board.is_revealed(x, y)) {
+                        continue;
+                    }
+                    covered++;
+                    known += known_bombs[x * width + y];
+                    open += !known_bombs[x * width + y] && !board.is_flagged(x, y);
+                }
+            }
+            if (known == bombs && open) {
+                return true;
+            }
+            if (covered == bombs && known < bombs) {
+                for (int x = std::max(0, row - 1); x < std::min(height, row + 2); ++x) {
+                    for (int y = std::max(0, column - 1); y < std::min(width, column + 2); ++y) {
+                        if (!board.is_revealed(x, y)) {
+                            known_bombs[x * width + y] = true;
+                        }
+                    }
+                }
+                marked = true;
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Picks a covered and unflagged cell which is not a known bomb.
+ *
+ * A few random cells are tried first, then the board is scanned from a random
+ * position so the search always ends on nearly cleared boards.
+ *
+ * @return false if there are no covered cells left.
+ */
+
+bool Bot::find_covered(int& row, int& column) {
+    const int width = board.get_width();
+    const int height = board.get_height();
+    for (int attempt = 0; attempt < 64; ++attempt) {
+        row = rng.get_random_number(0, height - 1);
+        column = rng.get_random_number(0, width - 1);
+        if (!board.is_revealed(row, column) && !board.is_flagged(row, column) && !known_bombs[row * width + column]) {
+            return true;
+        }
+    }
+    const int size = width * height;
+    const int start = rng.get_random_number(0, size - 1);
+    for (int i = 0; i < size; ++i) {
+        int index = (start + i) % size;
+        row = index / width;
+        column = index % width;
+        if (!board.is_revealed(row, column) && !board.is_flagged(row, column) && !known_bombs[index]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Makes a single move.
+ *
+ * Reveals all safe neighbours of a satisfied number if there is one, otherwise guesses a covered cell.
+ * Having nothing to reveal is not final, the other players may still reveal or unflag cells.
+ *
+ * @return `Move::HitBomb` if the bot revealed a bomb, `Move::NoMove` if all covered cells are flagged or known
+ * bombs, `Move::Moved` otherwise.
+ */
+
+Bot::Move Bot::play_move() {
+    int row, column;
+    if (find_satisfied(row, column)) {
+        const int width = board.get_width();
+        for (int x = std::max(0, row - 1); x < std::min(board.get_height(), row + 2); ++x) {
+            for (int y = std::max(0, column - 1); y < std::min(width, column + 2); ++y) {
+                if (!known_bombs[x * width + y] && board.reveal(x, y, id) < 0) {
+                    return Move::HitBomb;
+                }
+            }
+        }
+        return Move::Moved;
+    }
+    if (!find_covered(row, column)) {
+        return Move::NoMove;
+    }
+    return board.reveal(row, column, id) >= 0 ? Move::Moved : Move::HitBomb;
+}
+
+/**
+ * @brief Estimates the probability of a bomb in a covered cell from what the bot knows.
+ *
+ * Known bombs are certain. Otherwise every revealed number around the cell spreads its bombs which are
+ * not known yet over its covered neighbours which are not known bombs, and the highest share is taken.
+ * Used to shade the heat-map of the failure image.
+ *
+ * @param row Row of the cell.
+ * @param column Column of the cell.
+ * @return Probability from 0 to 1, negative when no revealed number touches the cell.
+ */
+
+float Bot::bomb_probability(int row, int column) const {
+    const int width = board.get_width();
+    const int height = board.get_height();
+    if (known_bombs[row * width + column]) {
+        return 1.0f;
+    }
+    float probability = -1.0f;
+    for (int x = std::max(0, row - 1); x < std::min(height, row + 2); ++x) {
+        for (int y = std::max(0, column - 1); y < std::min(width, column + 2); ++y) {
+            if (!board.is_revealed(x, y) || !board.get_bombs_around(x, y)) {
+                continue;
+            }
+            int known = 0;
+            int unknown = 0;
+            for (int i = std::max(0, x - 1); i < std::min(height, x + 2); ++i) {
+                for (int j = std::max(0, y - 1); j < std::min(width, y + 2); ++j) {
+                    if (!board.is_revealed(i, j)) {
+                        known += known_bombs[i * width + j];
+                        unknown += !known_bombs[i * width + j];
+                    }
+                }
+            }
+            if (unknown) {
+                probability = std::max(probability, static_cast<float>(board.get_bombs_around(x, y) - known) / unknown);
+            }
+        }
+    }
+    return probability;
+}
@@ -0,0 +1,49 @@
+/**
+ * @file bot.h
+ * @brief Class representing computer opponent in the competitive mode.
+ */
+
+#ifndef BOT_H
+#define BOT_H
+
+#include <chrono>
+#include <vector>
+
+#include "randomizer.h"
+#include "shared_board.h"
+
+/**
+ * @class Bot
+ * @brief A simple opponent revealing covered cells of a `SharedBoard` from its own thread.
+ *
+ * @details Before guessing the bot looks for a revealed number with as many covered neighbours as bombs
+ * around and remembers them as bombs, then reveals the other neighbours of a number whose bombs are all known.
+ * The bombs are kept by the bot instead of being flagged, the flags of the board belong to the human player.
+ * Only when nothing follows from the numbers a random covered cell is guessed.
+ */
+
+class Bot {
+public:
+    static constexpr std::chrono::milliseconds think_time{400};
+    /**
+     * @brief Outcome of a single move of the bot.
+     */
+    enum class Move {
+        Moved,
+        HitBomb,
+        NoMove
+    };
+private:
+    SharedBoard& board;
+    int id;
+    RandomNumberGenerator rng;
+    std::vector<bool> known_bombs;
+    bool find_satisfied(int& row, int& column);
+    bool find_covered(int& row, int& column);
+public:
+    Bot(SharedBoard& board, int id);
+    Move play_move();
+    float bomb_probability(int row, int column) const;
+};
+
+#endif //BOT_H
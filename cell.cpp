@@ -45,6 +45,13 @@ void Cell::mark_as_bomb() {
     is_bomb = true;
 }
 
+/**
+ * @brief Function used to remove a bomb from the cell when the board is adjusted to the first move.
+*/
+void Cell::unmark_as_bomb() {
+    is_bomb = false;
+}
+
 /**
  * @brief Function used to toggle if cell is marked as a bomb by the player.
 */
@@ -66,6 +73,13 @@ void Cell::update_counter() {
     bombs_around++;
 }
 
+/**
+ * @brief Decrements an amount of bombs around the current cell.
+*/
+void Cell::decrease_counter() {
+    bombs_around--;
+}
+
 /**
  * @brief Checks if the cell is a bomb.
  * 
@@ -28,9 +28,11 @@ public:
     bool get_is_revealed() const;
     int get_bombs_around() const;
     void mark_as_bomb();
+    void unmark_as_bomb();
     void flag_bomb();
     void reveal();
     void update_counter();
+    void decrease_counter();
     virtual void display(std::ostream& os) const;
     virtual bool is_empty() const { return false; }
     virtual bool is_mine() const { return false; }
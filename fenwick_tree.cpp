@@ -0,0 +1,72 @@
+/**
+ * @file fenwick_tree.cpp
+ * @brief Implementation of `FenwickTree2D` class.
+ */
+
+#include <algorithm>
+
+#include "fenwick_tree.h"
+
+/**
+ * @brief Changes the counter of a single cell.
+ *
+ * @param row Row of the cell.
+ * @param column Column of the cell.
+ * @param delta Value added to the counter, 1 or -1 for a plane of flags.
+ */
+
+void FenwickTree2D::add(int row, int column, int delta) {
+    const int stride = width + 1;
+    for (int i = row + 1; i <= height; i += i & -i) {
+        for (int j = column + 1; j <= width; j += j & -j) {
+            tree[i * stride + j] += delta;
+        }
+    }
+}
+
+/**
+ * @brief Sums the counters from the top left corner to the given cell (inclusive).
+ *
+ * @param row Row of the cell, -1 gives an empty sum.
+ * @param column Column of the cell, -1 gives an empty sum.
+ */
+
+int FenwickTree2D::prefix(int row, int column) const {
+    const int stride = width + 1;
+    int sum = 0;
+    for (int i = row + 1; i > 0; i -= i & -i) {
+        for (int j = column + 1; j > 0; j -= j & -j) {
+            sum += tree[i * stride + j];
+        }
+    }
+    return sum;
+}
+
+/**
+ * @brief Sums the counters of a rectangle, the parts outside of the grid are ignored.
+ *
+ * @param top First row of the rectangle.
+ * @param left First column of the rectangle.
+ * @param bottom Last row of the rectangle.
+ * @param right Last column of the rectangle.
+ * @return Sum of the counters, 0 for an empty rectangle.
+ */
+
+int FenwickTree2D::count(int top, int left, int bottom, int right) const {
+    top = std::max(top, 0);
+    left = std::max(left, 0);
+    bottom = std::min(bottom, height - 1);
+    right = std::min(right, width - 1);
+    if (top > bottom || left > right) {
+        return 0;
+    }
+    return prefix(bottom, right) - prefix(top - 1, right) - prefix(bottom, left - 1) + prefix(top - 1, left - 1);
+}
+
+/**
+ * @brief Sums the counters of the whole grid.
+ */
+
+int FenwickTree2D::total() const {
+    return prefix(height - 1, width - 1);
+}
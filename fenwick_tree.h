@@ -0,0 +1,66 @@
+/**
+ * @file fenwick_tree.h
+ * @brief Class counting set cells in rectangles of a grid which changes during the game.
+ */
+
+#ifndef FENWICK_TREE_H
+#define FENWICK_TREE_H
+
+#include <vector>
+
+/**
+ * @class FenwickTree2D
+ * @brief A two dimensional Fenwick (binary indexed) tree over a grid of counters.
+ *
+ * @details Both changing a cell and counting a rectangle take O(log(width) * log(height)),
+ * so planes like the flagged or covered cells can be kept up to date on every move.
+ */
+
+class FenwickTree2D {
+private:
+    int width = 0;
+    int height = 0;
+    std::vector<int> tree;
+    int prefix(int row, int column) const;
+public:
+    template <typename Predicate>
+    void build(int w, int h, Predicate is_set);
+    void add(int row, int column, int delta);
+    int count(int top, int left, int bottom, int right) const;
+    int total() const;
+};
+
+/**
+ * @brief Fills the tree from a predicate in O(width * height).
+ *
+ * @param w Width of the grid.
+ * @param h Height of the grid.
+ * @param is_set Called with the row and the column, true if the cell is counted.
+ */
+
+template <typename Predicate>
+void FenwickTree2D::build(int w, int h, Predicate is_set) {
+    width = w;
+    height = h;
+    const int stride = width + 1;
+    tree.assign(static_cast<std::size_t>(height + 1) * stride, 0);
+    for (int row = 1; row <= height; ++row) {
+        for (int column = 1; column <= width; ++column) {
+            tree[row * stride + column] += is_set(row - 1, column - 1) ? 1 : 0;
+            const int parent = column + (column & -column);
+            if (parent <= width) {
+                tree[row * stride + parent] += tree[row * stride + column];
+            }
+        }
+    }
+    for (int row = 1; row <= height; ++row) {
+        const int parent = row + (row & -row);
+        if (parent <= height) {
+            for (int column = 1; column <= width; ++column) {
+                tree[parent * stride + column] += tree[row * stride + column];
+            }
+        }
+    }
+}
+
+#endif //FENWICK_TREE_H
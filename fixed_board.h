@@ -0,0 +1,95 @@
+/**
+ * @file fixed_board.h
+ * @brief Class representing board with dimensions known at compile time.
+ */
+
+#ifndef FIXED_BOARD_H
+#define FIXED_BOARD_H
+
+#include <array>
+#include <cstdlib>
+
+#include "cell.h"
+#include "topology.h"
+#include "board_logic.h"
+
+/**
+ * @class FixedBoard
+ * @brief A board specialised for one of the standard presets.
+ *
+ * @details The cells are kept in a flat `std::array` surrounded by a one cell wide border.
+ * Border cells are created already revealed and never hold a bomb, so neighbour loops can
+ * walk the constexpr offset table without any bounds checks. The rules of the game come from
+ * `BoardLogic`, shared with `Board`, which stays in use for custom dimensions and shapes.
+ * Preset boards are always rectangular.
+ *
+ * @tparam W Width of the board.
+ * @tparam H Height of the board.
+ */
+
+template <int W, int H>
+class FixedBoard : public BoardLogic<FixedBoard<W, H>> {
+private:
+    friend class BoardLogic<FixedBoard<W, H>>;
+    static constexpr int stride = W + 2;
+    static constexpr int size = (W + 2) * (H + 2);
+    static constexpr std::array<int, 8> offsets = {
+        -stride - 1, -stride, -stride + 1,
+        -1,                    1,
+        stride - 1,  stride,  stride + 1
+    };
+    std::array<Cell, size> cells;
+    Cell* cell_data() { return cells.data(); }
+    const Cell* cell_data() const { return cells.data(); }
+    static constexpr int index(int row, int column) { return (row + 1) * stride + column + 1; }
+    static constexpr int row_of(int index) { return index / stride - 1; }
+    static constexpr int column_of(int index) { return index % stride - 1; }
+    static constexpr int position(int index) { return row_of(index) * W + column_of(index); }
+    static Topology::Neighbours neighbours(int index) {
+        return {{offsets.data(), index}, {offsets.data() + offsets.size(), index}};
+    }
+    static bool are_neighbours(int index, int other) {
+        return std::abs(row_of(index) - row_of(other)) <= 1 && std::abs(column_of(index) - column_of(other)) <= 1;
+    }
+public:
+    FixedBoard(int w, int h, int bombs, int x, int y, Shape shape = Shape::Rectangle);
+    void create_board();
+    static constexpr int get_width() { return W; }
+    static constexpr int get_height() { return H; }
+    static constexpr Shape get_shape() { return Shape::Rectangle; }
+};
+
+/**
+ * @brief Constructs a new FixedBoard object.
+ *
+ * The dimensions are taken from the template arguments, `w`, `h` and the shape are accepted
+ * only to keep the constructor interchangeable with `Board`.
+ *
+ * @param bombs Number of bombs to place on the board.
+ * @param x X-coordinate of the first cell.
+ * @param y Y-coordinate of the first cell.
+ */
+
+template <int W, int H>
+FixedBoard<W, H>::FixedBoard(int, int, int bombs, int x, int y, Shape) : BoardLogic<FixedBoard>(bombs, x, y) {
+    create_board();
+    this->reset_counts();
+}
+
+/**
+ * @brief Resets all cells and marks the border as revealed.
+ */
+
+template <int W, int H>
+void FixedBoard<W, H>::create_board() {
+    cells.fill(Cell());
+    for (int i = 0; i < size; ++i) {
+        int row = i / stride;
+        int column = i % stride;
+        if (row == 0 || row == H + 1 || column == 0 || column == W + 1) {
+            cells[i].reveal();
+        }
+    }
+}
+
+#endif //FIXED_BOARD_H
@@ -9,8 +9,11 @@
 #include "cell.h"
 #include "board.h"
 
+#include <algorithm>
 #include <vector>
 #include <string>
+#include <iostream>
+#include <iomanip>
 
 /**
  * @class GUI
@@ -37,11 +40,76 @@ R"(
    `9MMP'     
 )";
 public:
+    static constexpr int view_rows = 50;
+    static constexpr int view_columns = 60;
     GUI() = default;
-    void print_board(const Board& board) const;
+    template <typename BoardT>
+    void print_board(const BoardT& board, std::ostream& os = std::cout, int cursor_row = -1, int cursor_column = -1) const;
     void clear_terminal() const;
     void welcome_screen() const;
     void end_screen() const;
 };
 
+/**
+ * @brief Prints the board matrix to the given stream.
+ *
+ * This method walks the board cell by cell and prints each
+ * cell to the stream, arranging them in rows and columns.
+ * Works with both `Board` and the preset `FixedBoard` types. Odd rows of a hexagonal
+ * board are shifted right, so every cell sits between its neighbours above and below.
+ * Boards larger than `view_rows` x `view_columns` are shown through a window centred on the
+ * cursor, a line above the grid tells which part of the board is shown and labels too long
+ * for their column keep only their last digits.
+ *
+ * @param board The board object to be printed.
+ * @param os The output stream, the console by default.
+ * @param cursor_row Row of the cell shown in brackets, -1 when there is no cursor.
+ * @param cursor_column Column of the cell shown in brackets.
+ */
+
+template <typename BoardT>
+void GUI::print_board(const BoardT& board, std::ostream& os, int cursor_row, int cursor_column) const {
+    const int width = board.get_width();
+    const int height = board.get_height();
+    auto view_start = [](int cursor, int size, int view) {
+        return std::clamp(cursor - view / 2, 0, std::max(0, size - view));
+    };
+    const int first_row = view_start(cursor_row, height, view_rows);
+    const int last_row = std::min(height, first_row + view_rows);
+    const int first_column = view_start(cursor_column, width, view_columns);
+    const int last_column = std::min(width, first_column + view_columns);
+    const int col_amount = last_column - first_column;
+    if (width > view_columns || height > view_rows) {
+        os << "Rows " << first_row + 1 << "-" << last_row << ", columns " << first_column + 1 << "-" << last_column
+           << " of " << height << "x" << width << std::endl;
+    }
+    const bool hexagon = board.get_shape() == Shape::Hexagon;
+    const std::string half = hexagon ? " " : "";
+    os << " 💣 ┃"; //hope the emoji will not break
+    for (int i=first_column+1; i<=last_column; i++) {
+        os << std::setw(2) << (width > 99 ? i % 100 : i);
+        os << " ";
+    }
+    os << half << std::endl;
+    os << "━━━━╋";
+    for (int i=1; i<=col_amount; i++) {
+        os << "━━━";
+    }
+    os << (hexagon ? "━" : "") << "┓" << std::endl;
+    for (int row = first_row; row < last_row; row++) {
+        const bool shifted = hexagon && row % 2;
+        os << std::setw(3) << (height > 999 ? (row + 1) % 1000 : row + 1) << " ┃" << (shifted ? half : "");
+        for (int column = first_column; column < last_column; column++) {
+            bool selected = row == cursor_row && column == cursor_column;
+            os << (selected ? "[" : " ") << board.get_cell(row, column) << (selected ? "]" : " ");
+        }
+        os << (shifted ? "" : half) << "┃" <<  std::endl;
+    }
+    os << "━━━━┻";
+    for (int i=1; i<=col_amount; i++) {
+        os << "━━━";
+    }
+    os << (hexagon ? "━" : "") << "┛" << std::endl;
+}
+
 #endif // GUI_H
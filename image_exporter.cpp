@@ -0,0 +1,58 @@
+/**
+ * @file image_exporter.cpp
+ * @brief Implementation of `ImageExporter` class and related functionalities.
+ */
+
+#include <utility>
+
+#include "image_exporter.h"
+
+/**
+ * @brief Constructs a new ImageExporter object.
+ *
+ * @param format Format of the written images.
+ * @param show_mines If true covered bombs are shown as well, only for post-mortems after the game.
+ * @param band_rows Number of rows converted before they are written to the file.
+ */
+
+ImageExporter::ImageExporter(ImageFormat format, bool show_mines, int band_rows)
+    : format(format), show_mines(show_mines), band_rows(std::max(1, band_rows)) {}
+
+/**
+ * @brief Sets the bomb probability of covered cells used to draw a heat-map.
+ *
+ * @param heat_map Function returning the probability (0 to 1) of a bomb in a cell, negative when it is
+ * unknown, empty to disable.
+ */
+
+void ImageExporter::set_probability(Probability heat_map) {
+    probability = std::move(heat_map);
+}
+
+/**
+ * @brief Computes the colour of a single cell.
+ *
+ * @param cell Cell to be drawn.
+ * @param bomb_probability Probability of a bomb for covered cells, negative without a heat-map.
+ * @param pixel Output RGB triple.
+ */
+
+void ImageExporter::cell_color(const Cell& cell, float bomb_probability, unsigned char* pixel) const {
+    if (cell.get_is_marked()) {
+        pixel[0] = 255; pixel[1] = 200; pixel[2] = 0;
+    } else if (cell.get_is_bomb() && (cell.get_is_revealed() || show_mines)) {
+        pixel[0] = cell.get_is_revealed() ? 255 : 128; pixel[1] = 0; pixel[2] = 0;
+    } else if (!cell.get_is_revealed()) {
+        if (bomb_probability >= 0.0f) {
+            float clamped = std::min(1.0f, bomb_probability);
+            pixel[0] = static_cast<unsigned char>(255 * clamped);
+            pixel[1] = static_cast<unsigned char>(255 * (1.0f - clamped));
+            pixel[2] = 0;
+        } else {
+            pixel[0] = 128; pixel[1] = 128; pixel[2] = 128;
+        }
+    } else {
+        unsigned char shade = static_cast<unsigned char>(255 - 28 * cell.get_bombs_around());
+        pixel[0] = shade; pixel[1] = shade; pixel[2] = 255;
+    }
+}
@@ -0,0 +1,99 @@
+/**
+ * @file image_exporter.h
+ * @brief Class writing the board state as an image, one band of rows at a time.
+ */
+
+#ifndef IMAGE_EXPORTER_H
+#define IMAGE_EXPORTER_H
+
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "cell.h"
+
+/**
+ * @brief Image formats supported by the `ImageExporter`.
+ */
+
+enum class ImageFormat {
+    PPM,
+    PGM,
+    RawRGB
+};
+
+/**
+ * @class ImageExporter
+ * @brief A class exporting boards of any size as PPM, PGM or raw RGB images, one pixel per cell.
+ *
+ * @details Rows are converted into a buffer holding a single band of `band_rows` rows which is written
+ * out before the next band is built, so the extra memory is proportional to the width of the board.
+ * Works with every board type which provides `get_width`, `get_height` and `get_cell`.
+ *
+ * Colours: covered cells are gray, flags yellow, bombs red (dark red while covered, when `show_mines`
+ * is set) and revealed cells get darker blue with a growing number of bombs around. Covered bombs
+ * are only meant to be shown after the game, otherwise the image gives them away. With a probability
+ * callback covered cells are shaded from green (safe) to red (bomb) instead of gray.
+ */
+
+class ImageExporter {
+public:
+    using Probability = std::function<float(int row, int column)>;
+private:
+    ImageFormat format;
+    bool show_mines;
+    int band_rows;
+    Probability probability;
+    void cell_color(const Cell& cell, float bomb_probability, unsigned char* pixel) const;
+public:
+    explicit ImageExporter(ImageFormat format = ImageFormat::PPM, bool show_mines = false, int band_rows = 16);
+    void set_probability(Probability heat_map);
+    template <typename BoardT>
+    bool export_board(const BoardT& board, const std::string& path) const;
+};
+
+/**
+ * @brief Writes the board to a file.
+ *
+ * @param board Board to be exported.
+ * @param path Path of the image file.
+ * @return false if the file could not be written.
+ */
+
+template <typename BoardT>
+bool ImageExporter::export_board(const BoardT& board, const std::string& path) const {
+    const int width = board.get_width();
+    const int height = board.get_height();
+    const int channels = format == ImageFormat::PGM ? 1 : 3;
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (format == ImageFormat::PPM) {
+        file << "P6\n" << width << " " << height << "\n255\n";
+    } else if (format == ImageFormat::PGM) {
+        file << "P5\n" << width << " " << height << "\n255\n";
+    }
+    std::vector<unsigned char> band(static_cast<size_t>(band_rows) * width * channels);
+    unsigned char pixel[3];
+    for (int first = 0; first < height; first += band_rows) {
+        const int last = std::min(height, first + band_rows);
+        unsigned char* out = band.data();
+        for (int row = first; row < last; ++row) {
+            for (int column = 0; column < width; ++column) {
+                cell_color(board.get_cell(row, column), probability ? probability(row, column) : -1.0f, pixel);
+                if (channels == 1) {
+                    *out++ = static_cast<unsigned char>((pixel[0] * 77 + pixel[1] * 150 + pixel[2] * 29) >> 8);
+                } else {
+                    *out++ = pixel[0];
+                    *out++ = pixel[1];
+                    *out++ = pixel[2];
+                }
+            }
+        }
+        file.write(reinterpret_cast<const char*>(band.data()), out - band.data());
+    }
+    file.close();
+    return static_cast<bool>(file);
+}
+
+#endif //IMAGE_EXPORTER_H
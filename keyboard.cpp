@@ -0,0 +1,172 @@
+/**
+ * @file keyboard.cpp
+ * @brief Implementation of `KeyDecoder` and `Keyboard` classes.
+*/
+
+#include <iostream>
+
+#include "keyboard.h"
+
+#ifndef _WIN32
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief Feeds a single byte to the decoder.
+ *
+ * Recognised keys:
+ * - arrows or `h`, `j`, `k`, `l` move the cursor,
+ * - space or `r` reveals the cell,
+ * - `f` (un)marks a bomb,
+ * - `c` chords around a number,
+ * - `e` exports the board as an image,
+ * - `?` asks for a region hint around the cursor (ignored in the competitive mode),
+ * - `q` quits the game.
+ *
+ * @param byte Next byte read from the terminal.
+ * @param key Reference where the decoded key will be stored.
+ * @return true if the byte completed a key.
+ */
+
+bool KeyDecoder::feed(unsigned char byte, Key& key) {
+    switch (state) {
+        case State::Escape:
+            if (byte == '[' || byte == 'O') {
+                state = State::Sequence;
+                return false;
+            }
+            state = State::Idle;
+            return feed(byte, key);
+        case State::Sequence:
+            if ((byte >= '0' && byte <= '9') || byte == ';') {
+                return false;
+            }
+            state = State::Idle;
+            switch (byte) {
+                case 'A': key = Key::Up; return true;
+                case 'B': key = Key::Down; return true;
+                case 'C': key = Key::Right; return true;
+                case 'D': key = Key::Left; return true;
+                default: return false;
+            }
+        default:
+            break;
+    }
+    switch (byte) {
+        case 0x1b: state = State::Escape; return false;
+        case 'k': key = Key::Up; return true;
+        case 'j': key = Key::Down; return true;
+        case 'l': key = Key::Right; return true;
+        case 'h': key = Key::Left; return true;
+        case ' ':
+        case 'r': key = Key::Reveal; return true;
+        case 'f': key = Key::Flag; return true;
+        case 'c': key = Key::Chord; return true;
+        case 'e': key = Key::Export; return true;
+        case '?': key = Key::Hint; return true;
+        case 'q': key = Key::Quit; return true;
+        default: return false;
+    }
+}
+
+/**
+ * @brief Switches the terminal to raw mode if the standard input is a terminal.
+ *
+ * Canonical mode and echo are disabled, output processing is left untouched.
+ */
+
+Keyboard::Keyboard() {
+#ifndef _WIN32
+    if (!isatty(STDIN_FILENO) || tcgetattr(STDIN_FILENO, &original) != 0) {
+        return;
+    }
+    termios settings = original;
+    settings.c_lflag &= ~(ICANON | ECHO);
+    settings.c_cc[VMIN] = 0;
+    settings.c_cc[VTIME] = 0;
+    raw = tcsetattr(STDIN_FILENO, TCSANOW, &settings) == 0;
+#endif
+}
+
+/**
+ * @brief Restores the original terminal settings.
+ */
+
+Keyboard::~Keyboard() {
+#ifndef _WIN32
+    if (raw) {
+        tcsetattr(STDIN_FILENO, TCSANOW, &original);
+    }
+#endif
+}
+
+/**
+ * @brief Checks if the terminal has been switched to raw mode.
+ */
+
+bool Keyboard::is_raw() const {
+    return raw;
+}
+
+/**
+ * @brief Reads the next key.
+ *
+ * Bytes are read in chunks into a fixed buffer and decoded one by one, so no memory
+ * is allocated. The end of input is reported as `Key::Quit`.
+ *
+ * @param key Reference where the key will be stored.
+ * @param timeout_ms How long to wait for input, -1 waits forever.
+ * @return false if no key has been pressed in time.
+ */
+
+bool Keyboard::read_key(Key& key, int timeout_ms) {
+#ifdef _WIN32
+    (void)key;
+    (void)timeout_ms;
+    return false;
+#else
+    while (true) {
+        while (position < buffered) {
+            if (decoder.feed(buffer[position++], key)) {
+                return true;
+            }
+        }
+        pollfd input = {STDIN_FILENO, POLLIN, 0};
+        if (poll(&input, 1, timeout_ms) <= 0) {
+            return false;
+        }
+        ssize_t count = read(STDIN_FILENO, buffer, sizeof(buffer));
+        if (count <= 0) {
+            key = Key::Quit;
+            return true;
+        }
+        buffered = static_cast<int>(count);
+        position = 0;
+    }
+#endif
+}
+
+/**
+ * @brief Waits until the standard input can be read, used by line input.
+ *
+ * Lets the input stage notice the end of the game between lines instead of blocking in
+ * `std::getline`. Characters already buffered by `std::cin` count as available, which
+ * needs `std::ios::sync_with_stdio(false)` so `std::cin` keeps its own buffer.
+ *
+ * @param timeout_ms How long to wait for input, -1 waits forever.
+ * @return true if input, or the end of input, is available.
+ */
+
+bool Keyboard::wait_for_input(int timeout_ms) const {
+#ifdef _WIN32
+    (void)timeout_ms;
+    return true;
+#else
+    if (std::cin.rdbuf()->in_avail() != 0) {
+        return true;
+    }
+    pollfd input = {STDIN_FILENO, POLLIN, 0};
+    return poll(&input, 1, timeout_ms) > 0;
+#endif
+}
@@ -0,0 +1,80 @@
+/**
+ * @file keyboard.h
+ * @brief Classes reading single key presses from a terminal in raw mode.
+ */
+
+#ifndef KEYBOARD_H
+#define KEYBOARD_H
+
+#ifndef _WIN32
+#include <termios.h>
+#endif
+
+/**
+ * @brief Actions which can be triggered by a single key, `Hint` is the `?` key asking for a region hint.
+ */
+
+enum class Key {
+    None,
+    Up,
+    Down,
+    Left,
+    Right,
+    Reveal,
+    Flag,
+    Chord,
+    Export,
+    Hint,
+    Quit
+};
+
+/**
+ * @class KeyDecoder
+ * @brief A state machine turning terminal bytes into keys.
+ *
+ * @details Bytes are fed one at a time, escape sequences of the arrow keys are tracked
+ * in the state, so the decoder never allocates and never waits for more input. Letters,
+ * space and `?` map to a key directly, see `feed` for the full list.
+ */
+
+class KeyDecoder {
+private:
+    enum class State {
+        Idle,
+        Escape,
+        Sequence
+    };
+    State state = State::Idle;
+public:
+    bool feed(unsigned char byte, Key& key);
+};
+
+/**
+ * @class Keyboard
+ * @brief A class switching the terminal to raw mode for the lifetime of the object.
+ *
+ * @details Raw mode is only available on POSIX terminals. When the standard input is
+ * not a terminal `is_raw()` returns false and the game keeps using line input.
+ */
+
+class Keyboard {
+private:
+    KeyDecoder decoder;
+    unsigned char buffer[32];
+    int buffered = 0;
+    int position = 0;
+    bool raw = false;
+#ifndef _WIN32
+    termios original;
+#endif
+public:
+    Keyboard();
+    ~Keyboard();
+    Keyboard(const Keyboard&) = delete;
+    Keyboard& operator=(const Keyboard&) = delete;
+    bool is_raw() const;
+    bool read_key(Key& key, int timeout_ms);
+    bool wait_for_input(int timeout_ms) const;
+};
+
+#endif //KEYBOARD_H
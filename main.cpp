@@ -5,53 +5,206 @@
  * @brief Implementation of working minesweeper game.
 */
 
+#include <algorithm>
 #include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <atomic>
+#include <cstdlib>
+#include <ctime>
+#include <functional>
+#include <future>
+#include <thread>
+#include <vector>
+#include <string>
+#include <cmath>
 
 #include "player.h"
 #include "gui.h"
 #include "board.h"
+#include "fixed_board.h"
+#include "shared_board.h"
+#include "bot.h"
+#include "puzzle_bank.h"
+#include "image_exporter.h"
+#include "spectator_feed.h"
+#include "stats_store.h"
+#include "keyboard.h"
+#include "message_queue.h"
+#include "renderer.h"
 
 /**
- * @brief Main game loop for Minesweeper.
+ * @brief Moves read by the input stage from a single line or key press, together with the time they arrived.
  * 
- * @details This function initializes the game, sets up the board, and enters the main game loop where user interactions
- * are handled. The game loop continues until the user hits a bomb or wins the game. The following classes are used:
- *  - `Player` for handling user inputs and moves.
- *  - `Board` for maintaining the state of the game and checking win/loss conditions.
- *  - `GUI` for displaying the board and clearing the terminal.
+ * Every move is `(row, column, mode)`, the last one holds the cursor position. Player 0 is the human player,
+ * in the competitive mode bots report their moves with their own index and no moves. With line input the
+ * line is kept, so the lines read after the end of the game can be given back to the `Player`. A rejected
+ * line is queued without moves for the same reason.
  */
 
-void game_loop() {
-// setup for a game to run
-    bool running = true;
-    Player player;
-    GUI gui;
-    int row, column, mode;
-    int size_x;
-    int size_y;
-// board setup
-    std::tie(size_x, size_y) = player.get_board_dimensions();
-    gui.clear_terminal();
-// visualization of a board
-    Board representation(size_x, size_y, 0, 0, 0);
-    gui.print_board(representation);
-// board setup
-    int bomb_amount = std::floor((size_x * size_y) * 0.2);
-    std::tie(row, column, mode) = player.player_move(size_x, size_y);
-    Board board(size_x, size_y, bomb_amount, row, column);
-    board.create_board();
-    board.place_bombs();
+struct PendingBatch {
+    std::vector<std::tuple<int, int, int>> moves;
+    int player;
+    Renderer::Clock::time_point received;
+    std::string line;
+};
+
+/**
+ * @brief Prepares a frame showing the board in memory.
+ * 
+ * @param gui GUI used to format the board.
+ * @param board Board to be shown.
+ * @param status Message displayed below the board.
+ * @param prompt Prompt displayed after the message.
+ * @param cursor_row Row of the cursor, -1 when there is no cursor.
+ * @param cursor_column Column of the cursor.
+ * @return Frame which can be handed to the `Renderer`.
+ */
+
+template <typename BoardT>
+Renderer::Frame make_frame(const GUI& gui, const BoardT& board, const std::string& status, const std::string& prompt,
+                           int cursor_row, int cursor_column) {
+    std::ostringstream board_text;
+    gui.print_board(board, board_text, cursor_row, cursor_column);
+    return {board_text.str(), status, prompt};
+}
+
+/**
+ * @brief Counts the bombs around every cell of the board.
+ * 
+ * @param board Board with the bombs already placed.
+ * @param size_x Width of the board.
+ * @param size_y Height of the board.
+ */
+
+template <typename BoardT>
+void count_all_bombs(BoardT& board, int size_x, int size_y) {
     for (int i = 0; i < size_y; i++) {
         for (int j = 0; j < size_x; j++) {
             board.count_bombs(i, j);
         }
     }
-    board.handle_first_mode(board, board.get_cell(row, column), row, column);
-    gui.clear_terminal();
-    gui.print_board(board);
-// mainloop
-    while (running) {
-        std::tie(row, column, mode) = player.player_move(size_x, size_y);
+}
+
+/**
+ * @brief Counts the 3BV (the least number of clicks needed to clear the board).
+ * 
+ * @param board Board with the bombs already placed.
+ * @return 3BV of the board, 0 for torus and hexagonal boards.
+ */
+
+template <typename BoardT>
+int count_board_3bv(const BoardT& board) {
+    if (board.get_shape() != Shape::Rectangle) {
+        return 0;
+    }
+    const int width = board.get_width();
+    const int height = board.get_height();
+    std::vector<std::uint8_t> mines((width * height + 7) / 8, 0);
+    for (int i = 0; i < width * height; ++i) {
+        if (board.get_cell(i / width, i % width).get_is_bomb()) {
+            mines[i >> 3] |= 1 << (i & 7);
+        }
+    }
+    return PuzzleBank::count_3bv(width, height, mines.data());
+}
+
+/**
+ * @brief Prepares the statistics record of a finished game.
+ * 
+ * @param board Board of the game.
+ * @param player 0 for the human player, index of the bot otherwise.
+ * @param result Result of the game.
+ * @param time Time from the first reveal to the end of the game.
+ * @param bbbv 3BV of the board.
+ * @param moves Number of reveals, flags and chords.
+ * @return Record which can be handed to the `StatsStore`.
+ */
+
+template <typename BoardT>
+StatsStore::Record make_record(const BoardT& board, int bomb_amount, int player, StatsStore::Result result,
+                               Renderer::Clock::duration time, int bbbv, int moves) {
+    StatsStore::Record record{};
+    record.width = static_cast<std::uint16_t>(board.get_width());
+    record.height = static_cast<std::uint16_t>(board.get_height());
+    record.bombs = static_cast<std::uint16_t>(bomb_amount);
+    record.shape = static_cast<std::uint8_t>(board.get_shape());
+    record.result = result;
+    record.player = static_cast<std::uint32_t>(player);
+    record.time_ms = static_cast<std::uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(time).count());
+    record.bbbv = static_cast<std::uint32_t>(bbbv);
+    record.moves = static_cast<std::uint32_t>(moves);
+    record.finished_at = static_cast<std::int64_t>(std::time(nullptr));
+    return record;
+}
+
+/**
+ * @brief Translates the result of a game for the spectators.
+ * 
+ * @param result Result of the game as recorded in the statistics.
+ * @return Result sent by the `SpectatorFeed`.
+ */
+
+GameResult spectator_result(StatsStore::Result result) {
+    switch (result) {
+        case StatsStore::lost:
+            return result_lost;
+        case StatsStore::won:
+            return result_won;
+        default:
+            return result_quit;
+    }
+}
+
+/**
+ * @brief Builds the line comparing a won game with the earlier ones on the same board.
+ * 
+ * @param stats Statistics of the player.
+ * @param record The won game, not recorded yet.
+ * @return Time of the game, the best times and its percentile.
+ */
+
+std::string stats_line(const StatsStore& stats, const StatsStore::Record& record) {
+    const StatsStore::Key key{record.width, record.height, record.bombs, record.shape, record.player != 0};
+    std::ostringstream line;
+    line << std::fixed << std::setprecision(2) << "Your time: " << record.time_ms / 1000.0 << " s";
+    const std::vector<std::uint32_t> best = stats.best_times(key, 3);
+    if (!best.empty()) {
+        line << " | best:";
+        for (std::uint32_t time : best) {
+            line << " " << time / 1000.0 << " s";
+        }
+        line << std::setprecision(0) << " | faster than " << stats.percentile(key, record.time_ms) << "% of "
+             << stats.won_games(key) << " won games";
+    }
+    return line.str();
+}
+
+/**
+ * @brief Applies a batch of moves of the human player as a single update.
+ * 
+ * The moves are applied in order and the batch stops at the first revealed bomb, the moves after it are dropped.
+ * The board collects the cells changed by the whole batch, so the caller checks the win condition, draws and
+ * publishes the changes only once. An export (mode 4) and a region hint (mode 5) are left to the caller, after the
+ * rest of the batch.
+ * 
+ * @param board Board of the game.
+ * @param moves Moves of the batch.
+ * @param next Index of the first move to apply, the moves before it were already applied. Set to the index after
+ * the last applied move.
+ * @param export_requested Set if the batch asks for an image of the board.
+ * @param hint Set to the index of the last hint move of the batch, unchanged if there is none.
+ * @param moves_made Increased by every applied reveal, flag and chord.
+ * @return false if a bomb was revealed.
+ */
+
+template <typename BoardT>
+bool apply_moves(BoardT& board, const std::vector<std::tuple<int, int, int>>& moves, std::size_t& next,
+                 bool& export_requested, int& hint, int& moves_made) {
+    bool running = true;
+    for (; next < moves.size() && running; ++next) {
+        const auto [row, column, mode] = moves[next];
+        moves_made += mode >= 1 && mode <= 3;
         switch (mode) {
             case 1:
                 running = board.handle_first_mode(board, board.get_cell(row, column), row, column);
@@ -59,16 +212,551 @@ void game_loop() {
             case 2:
                 board.handle_second_mode(board.get_cell(row, column));
                 break;
+            case 3:
+                running = board.handle_third_mode(row, column);
+                break;
+            case 4:
+                export_requested = true;
+                break;
+            case 5:
+                hint = static_cast<int>(next);
+                break;
             default:
                 break;
         }
-        gui.clear_terminal();
-        gui.print_board(board);
-        if (!running) {
-            std::cout << "It was a bomb :c" << std::endl;
+    }
+    return running;
+}
+
+/**
+ * @brief Describes the bombs, flags and covered cells in the square around a cell.
+ * 
+ * Every count is a rectangle query on the board, so the hint costs the same on any board size.
+ * 
+ * @param board Board of the game.
+ * @param row Row of the center of the square.
+ * @param column Column of the center of the square.
+ * @return Status line with the one-based bounds of the square and its counts.
+ */
+
+template <typename BoardT>
+std::string region_hint(const BoardT& board, int row, int column) {
+    constexpr int radius = 2;
+    const int top = std::max(0, row - radius);
+    const int left = std::max(0, column - radius);
+    const int bottom = std::min(board.get_height() - 1, row + radius);
+    const int right = std::min(board.get_width() - 1, column + radius);
+    std::ostringstream line;
+    line << "Rows " << top + 1 << "-" << bottom + 1 << ", columns " << left + 1 << "-" << right + 1 << ": "
+         << board.count_mines(top, left, bottom, right) << " bombs, "
+         << board.count_flags(top, left, bottom, right) << " flagged, "
+         << board.count_covered(top, left, bottom, right) << " covered";
+    return line.str();
+}
+
+/**
+ * @brief Input stage of the game loop, run on its own thread.
+ * 
+ * Reads key presses (or whole lines when the terminal is not in raw mode), turns them into batches of moves of
+ * the human player and queues them without waiting for the logic, so moves entered while the logic or the
+ * terminal is busy pile up and are drawn together. A key press is a batch of one move, a line can hold several
+ * moves. Input is only awaited for a short time, so the stage stops soon after the logic ends the game, as well
+ * as when the player quits or when the input ends. The move queue is then closed.
+ * 
+ * @param player Player turning the input into moves.
+ * @param keyboard Keyboard in raw mode, or not raw when line input is used.
+ * @param renderer Renderer showing rejected lines.
+ * @param batches Queue of batches read for the logic.
+ * @param finished Set by the logic when the game is over.
+ * @param size_x Width of the board.
+ * @param size_y Height of the board.
+ * @param max_mode Highest mode supported by the game, 4 in the competitive mode which has no region hints.
+ */
+
+void read_moves(Player& player, Keyboard& keyboard, Renderer& renderer, MessageQueue<PendingBatch>& batches,
+                const std::atomic<bool>& finished, int size_x, int size_y, int max_mode) {
+    std::tuple<int, int, int> move;
+    std::vector<std::tuple<int, int, int>> moves;
+    std::string error;
+    std::string line;
+    while (!finished) {
+        if (keyboard.is_raw()) {
+            Key key;
+            if (!keyboard.read_key(key, 100) || finished) {
+                continue;
+            }
+            if (key == Key::Quit) {
+                break;
+            }
+            if (!player.key_move(key, move, size_x, size_y, max_mode)) {
+                continue;
+            }
+            moves.assign(1, move);
         } else {
-            running = board.handle_win_condition();
+            if (!player.has_unread() && !keyboard.wait_for_input(100)) {
+                continue;
+            }
+            if (!player.read_moves(moves, size_x, size_y, max_mode, error, line)) {
+                break;
+            }
+            if (!error.empty()) {
+                renderer.set_status(error);
+                moves.clear();
+            }
         }
+        batches.push({moves, 0, Renderer::Clock::now(), line});
+    }
+    batches.close();
+}
+
+/**
+ * @brief Gives the lines read by the input stage but not applied back to the player.
+ * 
+ * Called after the input stage has stopped, the lines were typed for the questions asked after the game.
+ * 
+ * @param player Player reading the answers.
+ * @param batches Queue of batches left after the end of the game.
+ */
+
+void give_back_lines(Player& player, MessageQueue<PendingBatch>& batches) {
+    std::vector<std::string> lines;
+    PendingBatch left;
+    while (batches.try_pop(left)) {
+        if (!left.line.empty()) {
+            lines.push_back(left.line);
+        }
+    }
+    player.unread_lines(lines);
+}
+
+/**
+ * @brief Waits for the next batch with something to apply, skipping the lines rejected by the input stage.
+ * 
+ * @param batches Queue of batches read for the logic.
+ * @param batch Reference where the batch will be stored.
+ * @return false if the input stage has stopped and no batches are left.
+ */
+
+bool next_batch(MessageQueue<PendingBatch>& batches, PendingBatch& batch) {
+    while (batches.pop(batch)) {
+        if (!batch.moves.empty() || batch.player != 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Takes the next batch with something to apply if one is already queued, without waiting for the input.
+ * 
+ * @param batches Queue of batches read for the logic.
+ * @param batch Reference where the batch will be stored.
+ * @return false if no batch with something to apply is queued.
+ */
+
+bool queued_batch(MessageQueue<PendingBatch>& batches, PendingBatch& batch) {
+    while (batches.try_pop(batch)) {
+        if (!batch.moves.empty() || batch.player != 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Plays a single game on the given board type.
+ * 
+ * @details The game runs as three stages connected by queues:
+ *  - the input thread reads key presses with `Keyboard` (or whole lines with `Player::read_moves` when the terminal
+ *    cannot be switched to raw mode) and pushes moves to the logic,
+ *  - the logic (this thread) updates the board and prepares frames in memory,
+ *  - the `Renderer` thread draws the newest frame, coalescing frames submitted while the terminal is busy.
+ * 
+ * Moves with mode 0 only move the cursor. The logic never touches the terminal. Once it takes a batch the logic
+ * also applies every batch queued behind it before formatting anything, so moves piled up while it was busy are
+ * one update: a single frame is drawn, an export is taken once and only the changed cells are published. The
+ * input stage never waits for the logic. When the game is over the logic tells the input stage to stop and gives
+ * the lines it read in the meantime back to the player, for the questions asked after the game.
+ * `BoardT` is either the dynamic `Board` or one of the `FixedBoard` presets.
+ * 
+ * When the puzzle bank holds a board of this size and difficulty it is used instead of generating one: the game
+ * starts at once with the safe first click of the stored board already revealed. Otherwise the board is generated
+ * in the background while the empty board is shown, and the bombs around the first move are relocated once it
+ * arrives. Only the presets are taken from the bank.
+ * 
+ * @param player Player providing the moves.
+ * @param gui GUI used to print the board.
+ * @param bank Puzzle bank, may be empty.
+ * @param feed Spectator feed receiving the changes of the board, may be closed.
+ * @param stats Statistics of the player, the game is recorded when it ends.
+ * @param size_x Width of the board.
+ * @param size_y Height of the board.
+ * @param bomb_amount Number of bombs to place.
+ * @param difficulty Difficulty of the board taken from the bank, -1 to always generate the board.
+ * @param shape Shape of the board, presets are always rectangular.
+ */
+
+template <typename BoardT>
+void play_game(Player& player, const GUI& gui, PuzzleBank& bank, SpectatorFeed& feed, StatsStore& stats,
+               int size_x, int size_y, int bomb_amount, int difficulty, Shape shape = Shape::Rectangle) {
+    Keyboard keyboard;
+    const bool raw = keyboard.is_raw();
+    const std::string key_prompt = "[arrows/hjkl - move | space - reveal | f - (un)mark bomb | c - chord | e - export image | ? - region hint | q - quit]";
+    const std::string first_prompt = raw ? key_prompt : "Insert move [row column]: ";
+    const std::string move_prompt = raw ? key_prompt : "Insert move [row column mode(1 - reveal cell | 2 - (un)mark bomb | 3 - chord | 4 - export image | 5 - region hint)]: ";
+    const std::string export_path = "board.ppm";
+    const ImageExporter exporter(ImageFormat::PPM, false);
+    const ImageExporter post_mortem_exporter(ImageFormat::PPM, true);
+    bool running = true;
+    std::atomic<bool> finished{false};
+    MessageQueue<PendingBatch> batches;
+    Renderer renderer(gui);
+    renderer.start();
+    feed.start_game();
+// visualization of a board
+    BoardT representation(size_x, size_y, 0, 0, 0, shape);
+    PendingBatch batch{{std::make_tuple(0, 0, 1)}, 0, Renderer::Clock::now(), ""};
+    PuzzleBank::Puzzle puzzle;
+    const bool from_bank = difficulty >= 0 && bank.pick(size_x, size_y, bomb_amount, difficulty, puzzle);
+    std::future<BoardT> speculative;
+    if (from_bank) {
+        batch.moves.front() = std::make_tuple(puzzle.first_x, puzzle.first_y, 1);
+        player.start_at(puzzle.first_x, puzzle.first_y);
+    } else {
+        speculative = std::async(std::launch::async, [size_x, size_y, bomb_amount, shape] {
+            BoardT generated(size_x, size_y, bomb_amount, 0, 0, shape);
+            generated.place_bombs(false);
+            count_all_bombs(generated, size_x, size_y);
+            return generated;
+        });
+        renderer.submit_frame(make_frame(gui, representation, "", first_prompt, raw ? 0 : -1, 0));
+    }
+// input stage
+    std::thread input(read_moves, std::ref(player), std::ref(keyboard), std::ref(renderer), std::ref(batches),
+                      std::cref(finished), size_x, size_y, 5);
+// waiting for the first reveal
+    bool waiting = !from_bank;
+    while (waiting) {
+        if (!next_batch(batches, batch)) {
+            input.join();
+            return;
+        }
+        if (std::get<2>(batch.moves.front()) != 1) {
+            const auto [row, column, mode] = batch.moves.back();
+            renderer.submit_frame(make_frame(gui, representation, "", first_prompt, row, column), batch.received);
+        } else {
+            waiting = false;
+        }
+    }
+// board setup
+    const auto [first_row, first_column, first_mode] = batch.moves.front();
+    BoardT board = from_bank ? BoardT(size_x, size_y, bomb_amount, first_row, first_column, shape) : speculative.get();
+    if (from_bank) {
+        board.place_bombs_from(puzzle.mines);
+        count_all_bombs(board, size_x, size_y);
+    } else {
+        board.relocate_bombs(first_row, first_column);
+    }
+    board.handle_first_mode(board, board.get_cell(first_row, first_column), first_row, first_column);
+    const auto started = Renderer::Clock::now();
+    const int bbbv = from_bank ? puzzle.bbbv : count_board_3bv(board);
+    int moves_made = 1;
+    StatsStore::Result result = StatsStore::quit;
+// mainloop, the rest of the first batch is applied in the first pass
+    std::size_t applied = 1;
+    do {
+        std::string status;
+        bool export_requested = false;
+        int row = 0;
+        int column = 0;
+        const Renderer::Clock::time_point received = batch.received;
+        do {
+            int hint = -1;
+            running = apply_moves(board, batch.moves, applied, export_requested, hint, moves_made);
+            std::tie(row, column, std::ignore) = batch.moves[applied - 1];
+            applied = 0;
+            if (hint >= 0) {
+                const auto [hint_row, hint_column, hint_mode] = batch.moves[hint];
+                status = region_hint(board, hint_row, hint_column);
+            }
+            if (!running) {
+                status = "It was a bomb :c";
+                result = StatsStore::lost;
+            } else {
+                running = board.handle_win_condition();
+                if (!running) {
+                    status = "You won the game!!!";
+                    result = StatsStore::won;
+                }
+            }
+        } while (running && queued_batch(batches, batch));
+        if (export_requested) {
+            const ImageExporter& chosen = running ? exporter : post_mortem_exporter;
+            status += (status.empty() ? "" : " | ") + (chosen.export_board(board, export_path)
+                                                       ? "Board exported to " + export_path
+                                                       : "Could not write " + export_path);
+        }
+        finished = !running;
+        renderer.submit_frame(make_frame(gui, board, status, running ? move_prompt : "", row, column), received);
+        feed.publish(board, board.get_changed());
+        board.clear_changed();
+    } while (running && next_batch(batches, batch));
+    const StatsStore::Record record = make_record(board, bomb_amount, 0, result, Renderer::Clock::now() - started,
+                                                  bbbv, moves_made);
+    const std::string summary = result == StatsStore::won ? stats_line(stats, record) : "";
+    stats.record(record);
+    feed.finish_game(spectator_result(result));
+    finished = true;
+    input.join();
+    give_back_lines(player, batches);
+    renderer.stop();
+    std::cout << std::endl << renderer.latency_report();
+    if (!summary.empty()) {
+        std::cout << summary << std::endl;
+    }
+}
+
+/**
+ * @brief Builds the score line of the competitive mode.
+ * 
+ * @param board Board holding the scores.
+ * @param alive Which bots are still in the game.
+ * @return Scores of the player and all bots.
+ */
+
+std::string score_line(const SharedBoard& board, const std::vector<std::atomic<bool>>& alive) {
+    std::ostringstream line;
+    line << "You: " << board.get_score(0);
+    for (size_t bot = 1; bot < alive.size(); ++bot) {
+        line << " | Bot " << bot << ": " << board.get_score(bot) << (alive[bot] ? "" : " (out)");
+    }
+    return line.str();
+}
+
+/**
+ * @brief Plays a competitive game against bots on a `SharedBoard`.
+ * 
+ * @details The stages are the same as in `play_game`. After the first reveal every bot starts on its own thread
+ * and makes a move on the shared board every `Bot::think_time`, then notifies the logic with an empty batch so a
+ * new frame is drawn. As in `play_game` the logic applies every batch queued behind the one it took, so the
+ * notifications of all bots which moved meanwhile end in a single frame, and only the cells changed since the
+ * previous frame are published. Every revealed cell is credited to exactly one player. The game ends when the
+ * board is cleared or the human player reveals a bomb. A bot which reveals a bomb exports the board to
+ * `bot_<id>_failure.ppm` with all bombs shown for later analysis, the other covered cells are shaded by the bomb
+ * probability the bot saw. A bot with nothing to reveal waits for the other players, it is neither out of the
+ * game nor notifies the logic.
+ * 
+ * @param player Player providing the moves.
+ * @param gui GUI used to print the board.
+ * @param feed Spectator feed receiving the changes of the board, may be closed.
+ * @param stats Statistics of the player, the game is recorded when it ends.
+ * @param size_x Width of the board.
+ * @param size_y Height of the board.
+ * @param bomb_amount Number of bombs to place.
+ * @param bot_amount Number of bots playing against the player.
+ */
+
+void play_competitive(Player& player, const GUI& gui, SpectatorFeed& feed, StatsStore& stats, int size_x, int size_y,
+                      int bomb_amount, int bot_amount) {
+    Keyboard keyboard;
+    const bool raw = keyboard.is_raw();
+    const std::string key_prompt = "[arrows/hjkl - move | space - reveal | f - (un)mark bomb | c - chord | e - export image | q - quit]";
+    const std::string first_prompt = raw ? key_prompt : "Insert move [row column]: ";
+    const std::string move_prompt = raw ? key_prompt : "Insert move [row column mode(1 - reveal cell | 2 - (un)mark bomb | 3 - chord | 4 - export image)]: ";
+    const std::string export_path = "board.ppm";
+    const ImageExporter exporter(ImageFormat::PPM, false);
+    const ImageExporter post_mortem_exporter(ImageFormat::PPM, true);
+    bool running = true;
+    std::atomic<bool> finished{false};
+    std::vector<std::atomic<bool>> alive(bot_amount + 1);
+    std::vector<int> bot_moves(bot_amount + 1, 0);
+    MessageQueue<PendingBatch> batches;
+    Renderer renderer(gui);
+    renderer.start();
+    feed.start_game();
+    SharedBoard board(size_x, size_y, bomb_amount);
+    renderer.submit_frame(make_frame(gui, board, "", first_prompt, raw ? 0 : -1, 0));
+// input stage
+    std::thread input(read_moves, std::ref(player), std::ref(keyboard), std::ref(renderer), std::ref(batches),
+                      std::cref(finished), size_x, size_y, 4);
+// waiting for the first reveal
+    PendingBatch batch;
+    int cursor_row = 0;
+    int cursor_column = 0;
+    do {
+        if (!next_batch(batches, batch)) {
+            input.join();
+            return;
+        }
+        std::tie(cursor_row, cursor_column, std::ignore) = batch.moves.back();
+        if (std::get<2>(batch.moves.front()) != 1) {
+            renderer.submit_frame(make_frame(gui, board, "", first_prompt, cursor_row, cursor_column), batch.received);
+        }
+    } while (std::get<2>(batch.moves.front()) != 1);
+// board setup
+    const auto [first_row, first_column, first_mode] = batch.moves.front();
+    board.place_bombs(first_row, first_column);
+    board.count_bombs();
+    board.reveal(first_row, first_column, 0);
+    const auto started = Renderer::Clock::now();
+    const int bbbv = count_board_3bv(board);
+    int moves_made = 1;
+    bool human_lost = false;
+// bots
+    std::vector<std::thread> bots;
+    for (int id = 1; id <= bot_amount; ++id) {
+        alive[id] = true;
+        bots.emplace_back([&, id] {
+            Bot bot(board, id);
+            ImageExporter failure_exporter(ImageFormat::PPM, true);
+            failure_exporter.set_probability([&bot](int row, int column) { return bot.bomb_probability(row, column); });
+            while (!finished) {
+                std::this_thread::sleep_for(Bot::think_time);
+                if (finished) {
+                    break;
+                }
+                const Bot::Move move = bot.play_move();
+                if (move == Bot::Move::NoMove) {
+                    continue;
+                }
+                alive[id] = move == Bot::Move::Moved;
+                bot_moves[id]++;
+                if (!alive[id]) {
+                    failure_exporter.export_board(board, "bot_" + std::to_string(id) + "_failure.ppm");
+                }
+                batches.push({{}, id, Renderer::Clock::now(), ""});
+                if (!alive[id]) {
+                    break;
+                }
+            }
+        });
+    }
+// mainloop, the rest of the first batch is applied in the first pass
+    std::vector<std::uint64_t> seen;
+    std::vector<int> changed;
+    std::size_t applied = 1;
+    do {
+        std::string status;
+        bool export_requested = false;
+        const Renderer::Clock::time_point received = batch.received;
+        do {
+            if (batch.player != 0) {
+                continue;
+            }
+            for (; applied < batch.moves.size() && running; ++applied) {
+                const auto [row, column, mode] = batch.moves[applied];
+                moves_made += mode >= 1 && mode <= 3;
+                switch (mode) {
+                    case 1:
+                        running = board.reveal(row, column, 0) >= 0;
+                        break;
+                    case 2:
+                        board.toggle_flag(row, column);
+                        break;
+                    case 3:
+                        running = board.chord(row, column, 0) >= 0;
+                        break;
+                    case 4:
+                        export_requested = true;
+                        break;
+                    default:
+                        break;
+                }
+            }
+            std::tie(cursor_row, cursor_column, std::ignore) = batch.moves[applied - 1];
+            applied = 0;
+            if (!running) {
+                status = "It was a bomb :c ";
+                human_lost = true;
+            }
+        } while (running && queued_batch(batches, batch));
+        if (running && board.is_cleared()) {
+            running = false;
+            status = "Board cleared! ";
+        }
+        if (export_requested) {
+            const ImageExporter& chosen = running ? exporter : post_mortem_exporter;
+            status += chosen.export_board(board, export_path) ? "Board exported to " + export_path + " "
+                                                              : "Could not write " + export_path + " ";
+        }
+        if (!running) {
+            finished = true;
+            board.reveal_all();
+        }
+        renderer.submit_frame(make_frame(gui, board, status + score_line(board, alive),
+                                         running ? move_prompt : "", cursor_row, cursor_column),
+                              received);
+        changed.clear();
+        board.collect_changed(seen, changed);
+        feed.publish(board, changed);
+    } while (running && next_batch(batches, batch));
+    finished = true;
+    for (auto& bot : bots) {
+        bot.join();
+    }
+    const auto time = Renderer::Clock::now() - started;
+    const bool cleared = board.is_cleared();
+    const StatsStore::Result result = human_lost ? StatsStore::lost : (cleared ? StatsStore::won : StatsStore::quit);
+    stats.record(make_record(board, bomb_amount, 0, result, time, bbbv, moves_made));
+    feed.finish_game(spectator_result(result));
+    for (int id = 1; id <= bot_amount; ++id) {
+        stats.record(make_record(board, bomb_amount, id,
+                                 !alive[id] ? StatsStore::lost : (cleared ? StatsStore::won : StatsStore::quit),
+                                 time, bbbv, bot_moves[id]));
+    }
+    input.join();
+    give_back_lines(player, batches);
+    renderer.stop();
+    std::cout << std::endl << renderer.latency_report();
+}
+
+/**
+ * @brief Main game loop for Minesweeper.
+ * 
+ * @details This function asks for the board preset and starts the game on the matching board type. The standard
+ * presets use the compile-time specialised `FixedBoard`, custom dimensions fall back to the dynamic `Board`.
+ * Boards of the presets are taken from the `PuzzleBank` file when it exists, the player then chooses their difficulty. The following classes are used:
+ *  - `Player` for handling user inputs and moves.
+ *  - `Board` / `FixedBoard` for maintaining the state of the game and checking win/loss conditions.
+ *  - `GUI` for displaying the board and clearing the terminal.
+ * 
+ * @param player Player of the whole session, keeps the input read ahead during a game.
+ * @param feed Spectator feed receiving the changes of the board, may be closed.
+ * @param stats Statistics of the player, every finished game is recorded.
+ */
+
+void game_loop(Player& player, SpectatorFeed& feed, StatsStore& stats) {
+// setup for a game to run
+    player.new_game();
+    GUI gui;
+    int size_x;
+    int size_y;
+    int bot_amount;
+    Shape shape;
+    PuzzleBank bank;
+    bank.open(PuzzleBank::default_path);
+    auto difficulty = [&] { return bank.is_open() ? player.choose_difficulty() : -1; };
+// board setup
+    switch (player.choose_preset()) {
+        case Preset::Beginner:
+            play_game<FixedBoard<9, 9>>(player, gui, bank, feed, stats, 9, 9, 10, difficulty());
+            break;
+        case Preset::Intermediate:
+            play_game<FixedBoard<16, 16>>(player, gui, bank, feed, stats, 16, 16, 40, difficulty());
+            break;
+        case Preset::Expert:
+            play_game<FixedBoard<30, 16>>(player, gui, bank, feed, stats, 30, 16, 99, difficulty());
+            break;
+        case Preset::Competitive:
+            std::tie(size_x, size_y) = player.get_board_dimensions(SharedBoard::max_size);
+            player.verify_input(bot_amount, "Provide number of bots: ", 1, SharedBoard::max_players - 1);
+            play_competitive(player, gui, feed, stats, size_x, size_y, std::floor((size_x * size_y) * 0.2), bot_amount);
+            break;
+        default:
+            std::tie(size_x, size_y) = player.get_board_dimensions(50);
+            shape = player.choose_shape();
+            play_game<Board>(player, gui, bank, feed, stats, size_x, size_y, std::floor((size_x * size_y) * 0.2), -1, shape);
+            break;
     }
 }
 
@@ -76,28 +764,51 @@ void game_loop() {
  * @brief Main function of the project.
  * 
  * @details The main function initializes the game and handles the welcome screen and game loop.
- * The game loop continues until the user decides to end game.
+ * The game loop continues until the user decides to end game. Started with `--spectate <target>` the game
+ * streams its changes to a file, named pipe or local socket (`unix:<path>`) for `tools/spectator_viewer.cpp`.
+ * Every finished game is recorded in the statistics of the user (`stats_<user>.log`). The standard input is
+ * not synchronised with C stdio, so the line input stage can see the lines already buffered by `std::cin`.
  * 
  * The following classes are implemented in the game:
  *  - `Player` for handling user interactions.
  *  - `Board` for maintaining the state of the game.
  *  - `GUI` for displaying the game board and messages.
  * 
- * @return int Returns 0 on success.
+ * @param argc Number of command line arguments.
+ * @param argv Command line arguments.
+ * @return int Returns 0 on success, 1 if the spectator target could not be opened.
  */
 
-int main() {
+int main(int argc, char* argv[]) {
+    std::ios::sync_with_stdio(false);
     Player player;
     GUI gui;
+    SpectatorFeed feed;
+    StatsStore stats;
+    const char* user = std::getenv("USER") ? std::getenv("USER") : std::getenv("USERNAME");
+    stats.open(std::string(StatsStore::default_name) + "_" + (user ? user : "player"));
+    if (stats.damaged_records()) {
+        std::cerr << "Skipped " << stats.damaged_records() << " damaged records of the statistics log" << std::endl;
+    }
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::string(argv[i]) == "--spectate" && !feed.open(argv[++i])) {
+            std::cerr << "Could not open spectator target " << argv[i] << std::endl;
+            return 1;
+        }
+    }
     gui.welcome_screen();
-    game_loop();
+    game_loop(player, feed, stats);
     while (true) {
         if (player.play_again()) {
-            game_loop();
+            game_loop(player, feed, stats);
         } else {
             break;
         }
     }
     gui.end_screen();
+    stats.close();
+    if (stats.dropped_records()) {
+        std::cerr << "Could not write " << stats.dropped_records() << " games to the statistics log" << std::endl;
+    }
     return 0;
 }
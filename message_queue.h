@@ -0,0 +1,105 @@
+/**
+ * @file message_queue.h
+ * @brief Thread-safe queue connecting the stages of the game loop.
+ */
+
+#ifndef MESSAGE_QUEUE_H
+#define MESSAGE_QUEUE_H
+
+#include <condition_variable>
+#include <mutex>
+#include <queue>
+#include <utility>
+
+/**
+ * @class MessageQueue
+ * @brief A blocking FIFO queue that can be closed by the producer.
+ *
+ * @tparam T Type of the queued messages.
+ */
+
+template <typename T>
+class MessageQueue {
+private:
+    std::queue<T> messages;
+    std::mutex mutex;
+    std::condition_variable available;
+    bool closed = false;
+public:
+    void push(T message);
+    bool pop(T& message);
+    bool try_pop(T& message);
+    void close();
+};
+
+/**
+ * @brief Adds a message to the end of the queue and wakes up one consumer.
+ *
+ * Messages pushed after the queue has been closed are dropped.
+ *
+ * @param message The message to enqueue.
+ */
+
+template <typename T>
+void MessageQueue<T>::push(T message) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (closed) {
+            return;
+        }
+        messages.push(std::move(message));
+    }
+    available.notify_one();
+}
+
+/**
+ * @brief Waits for the next message.
+ *
+ * @param message Reference where the message will be stored.
+ * @return false if the queue has been closed and no messages are left.
+ */
+
+template <typename T>
+bool MessageQueue<T>::pop(T& message) {
+    std::unique_lock<std::mutex> lock(mutex);
+    available.wait(lock, [this] { return !messages.empty() || closed; });
+    if (messages.empty()) {
+        return false;
+    }
+    message = std::move(messages.front());
+    messages.pop();
+    return true;
+}
+
+/**
+ * @brief Takes the next message without waiting.
+ *
+ * @param message Reference where the message will be stored.
+ * @return true if a message was taken.
+ */
+
+template <typename T>
+bool MessageQueue<T>::try_pop(T& message) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (messages.empty()) {
+        return false;
+    }
+    message = std::move(messages.front());
+    messages.pop();
+    return true;
+}
+
+/**
+ * @brief Closes the queue, waking up all waiting consumers.
+ */
+
+template <typename T>
+void MessageQueue<T>::close() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+    }
+    available.notify_all();
+}
+
+#endif //MESSAGE_QUEUE_H
@@ -3,7 +3,10 @@
  * @brief Implementation of `Player` class and related functionalities.
 */
 
+#include <algorithm>
 #include <iostream>
+#include <sstream>
+#include <vector>
 #include <limits>
 #include <cmath>
 
@@ -11,32 +14,194 @@
 #include "gui.h"
 
 /**
- * @brief Gets the player's move.
+ * @brief Resets the cursor and the first move before a new game.
+ */
+
+void Player::new_game() {
+    first_move = true;
+    cursor_row = 0;
+    cursor_column = 0;
+}
+
+/**
+ * @brief Reads a line, taking the lines given back with `unread_lines` first.
+ * 
+ * @param line Reference where the line will be stored.
+ * @return false if the input stream has ended.
+ */
+
+bool Player::read_line(std::string& line) {
+    if (!unread.empty()) {
+        line = std::move(unread.front());
+        unread.pop_front();
+        return true;
+    }
+    return static_cast<bool>(std::getline(std::cin, line));
+}
+
+/**
+ * @brief Gives back lines read ahead by the input stage but not used by the game.
+ * 
+ * Line input is read while the game goes on, so the lines typed (or piped) after the last move
+ * belong to the questions asked after the game, like `play_again`.
+ * 
+ * @param lines The lines in the order they were read.
+ */
+
+void Player::unread_lines(const std::vector<std::string>& lines) {
+    unread.insert(unread.begin(), lines.begin(), lines.end());
+}
+
+/**
+ * @brief Checks if there are lines given back with `unread_lines` left to read.
+ */
+
+bool Player::has_unread() const {
+    return !unread.empty();
+}
+
+/**
+ * @brief Treats the first move as already made at the given cell.
+ * 
+ * Used when the board comes from the puzzle bank with its safe first click revealed.
+ * 
+ * @param row Row of the first move.
+ * @param column Column of the first move.
+ */
+
+void Player::start_at(int row, int column) {
+    first_move = false;
+    cursor_row = row;
+    cursor_column = column;
+}
+
+/**
+ * @brief Turns a key press into a move at the cursor position.
  * 
- * Prompts the player to input the coordinates and the mode of the move.
- * The coordinates are adjusted to zero-based indexing for internal processing.
+ * Cursor keys move the cursor and produce mode 0, which only redraws the board.
+ * The action keys produce mode 1 (reveal), 2 ((un)mark bomb), 3 (chord), 4 (export image)
+ * or 5 (region hint) at the cursor.
  * 
+ * @param key Key pressed by the player.
+ * @param move Reference where the zero-based move will be stored.
  * @param board_x The maximum x-coordinate (width) of the board.
  * @param board_y The maximum y-coordinate (height) of the board.
- * @return A tuple containing the x-coordinate, y-coordinate, and mode of the move.
+ * @param max_mode Highest mode supported by the game, keys of higher modes are ignored.
+ * @return false if the key does not produce a move.
+ */
+
+bool Player::key_move(Key key, std::tuple<int, int, int>& move, int board_x, int board_y, int max_mode) {
+    int mode = 0;
+    switch (key) {
+        case Key::Up:
+            cursor_row = std::max(0, cursor_row - 1);
+            break;
+        case Key::Down:
+            cursor_row = std::min(board_y - 1, cursor_row + 1);
+            break;
+        case Key::Left:
+            cursor_column = std::max(0, cursor_column - 1);
+            break;
+        case Key::Right:
+            cursor_column = std::min(board_x - 1, cursor_column + 1);
+            break;
+        case Key::Reveal:
+            mode = 1;
+            break;
+        case Key::Flag:
+            mode = 2;
+            break;
+        case Key::Chord:
+            mode = 3;
+            break;
+        case Key::Export:
+            mode = 4;
+            break;
+        case Key::Hint:
+            mode = 5;
+            break;
+        default:
+            return false;
+    }
+    if (mode > max_mode) {
+        return false;
+    }
+    move = std::make_tuple(cursor_row, cursor_column, mode);
+    return true;
+}
+
+/**
+ * @brief Reads all moves from a single line without printing anything.
  * 
- * @details The function asks the player to input the row and column where they
- * want to make a move, as well as the mode of the move (1 to reveal a cell or
- * 2 to mark/un-mark a bomb). It verifies that the inputs are within valid ranges
- * before returning them as a tuple.
+ * Every move holds the row, the column and optionally the mode separated by spaces,
+ * the mode defaults to 1 (reveal cell). Several moves are separated by `;`, for example
+ * `3 4 2; 3 5 2; 4 4 3` flags two cells and chords next to them. The line is accepted only
+ * when all of its moves are valid. It is used by the input stage of the game loop,
+ * where all terminal output belongs to the `Renderer`.
+ * 
+ * @param moves Vector where the zero-based moves will be stored, in the order they were entered.
+ * @param board_x The maximum x-coordinate (width) of the board.
+ * @param board_y The maximum y-coordinate (height) of the board.
+ * @param max_mode Highest mode supported by the game, 5 with region hints and 4 in the competitive mode.
+ * @param error Set to the reason why the line was rejected, empty if the moves are valid.
+ * @param line Set to the line as it was read.
+ * @return false if the input stream has ended.
  */
 
-std::tuple<int, int, int> Player::player_move(int board_x, int board_y)
-{
-    int x_cord, y_cord, mode;
-    verify_input(x_cord, "Insert row: ", 1, board_y);
-    verify_input(y_cord, "Insert column: ", 1, board_x);
+bool Player::read_moves(std::vector<std::tuple<int, int, int>>& moves, int board_x, int board_y, int max_mode,
+                        std::string& error, std::string& line) {
+    if (!read_line(line)) {
+        return false;
+    }
+    error.clear();
+    moves.clear();
+    std::istringstream parts(line);
+    std::string part;
+    while (std::getline(parts, part, ';')) {
+        std::istringstream tokens(part);
+        std::vector<int> values;
+        std::string token;
+        while (tokens >> token) {
+            try {
+                size_t pos;
+                values.push_back(std::stoi(token, &pos));
+                if (pos != token.length()) {
+                    error = "Invalid input. Please enter a valid integer.";
+                    return true;
+                }
+            } catch (std::invalid_argument& e) {
+                error = "Invalid input. Please enter a valid integer.";
+                return true;
+            } catch (std::out_of_range& e) {
+                error = "Number out of range. Please enter a smaller number.";
+                return true;
+            }
+        }
+        if (values.empty() && !moves.empty()) {
+            continue;
+        }
+        if (values.size() < 2 || values.size() > 3) {
+            error = "Please enter row, column and optionally mode, separate moves with ';'.";
+            return true;
+        }
+        int mode = values.size() == 3 ? values[2] : 1;
+        if (values[0] < 1 || values[0] > board_y || values[1] < 1 || values[1] > board_x || mode < 1 || mode > max_mode) {
+            error = "Input out of range. Please enter a cell on the board and mode from 1 to " + std::to_string(max_mode) + ".";
+            return true;
+        }
+        moves.emplace_back(values[0] - 1, values[1] - 1, mode);
+    }
+    if (moves.empty()) {
+        error = "Please enter row, column and optionally mode, separate moves with ';'.";
+        return true;
+    }
     if (first_move) {
         first_move = false;
-        return std::make_tuple(x_cord-1, y_cord-1, 1);
+        std::get<2>(moves.front()) = 1;
     }
-    verify_input(mode, "Insert mode [1 - reveal cell | 2 - (un)mark bomb]: ", 1, 2);
-    return std::make_tuple(x_cord-1, y_cord-1, mode);
+    cursor_row = std::get<0>(moves.back());
+    cursor_column = std::get<1>(moves.back());
+    return true;
 }
 
 /**
@@ -59,7 +224,7 @@ bool Player::verify_input(int& input, const std::string& prompt, int min, int ma
     while (true) {
         std::cout << prompt;
         std::string line;
-        std::getline(std::cin, line);
+        read_line(line);
         if (line.empty()) {
             GUI gui;
             gui.clear_terminal();
@@ -91,36 +256,99 @@ bool Player::verify_input(int& input, const std::string& prompt, int min, int ma
  * 
  * Prompts the player to input the width and height of the game board.
  * 
+ * @param max_size Largest allowed width and height.
  * @return A tuple containing the width and height of the board.
  * 
  * @details The function asks the player to input the dimensions of the game board.
- * It verifies that the inputs are within valid ranges (width and height between 5 and 100)
+ * It verifies that the inputs are within valid ranges (width and height between 5 and `max_size`)
  * before returning them as a tuple.
  */
 
-std::tuple<int, int> Player::get_board_dimensions() {
+std::tuple<int, int> Player::get_board_dimensions(int max_size) {
     int width, height;
-    verify_input(width, "Provide width of the board: ", 5, 50);
-    verify_input(height, "Provide height of the board: ", 5, 50);
+    verify_input(width, "Provide width of the board: ", 5, max_size);
+    verify_input(height, "Provide height of the board: ", 5, max_size);
     return std::make_tuple(width, height);
 }
 
+/**
+ * @brief Asks for the shape of a custom board.
+ * 
+ * @return Rectangle, torus (edges wrap around) or hexagonal board.
+ */
+
+Shape Player::choose_shape() {
+    int choice;
+    verify_input(choice, "Select shape [1 - rectangle | 2 - torus (edges wrap around) | 3 - hexagonal]: ", 1, 3);
+    switch (choice) {
+        case 2:
+            return Shape::Torus;
+        case 3:
+            return Shape::Hexagon;
+        default:
+            return Shape::Rectangle;
+    }
+}
+
+/**
+ * @brief Asks for the difficulty of a board taken from the puzzle bank.
+ * 
+ * @return 0 for easy, 1 for medium and 2 for hard boards.
+ */
+
+int Player::choose_difficulty() {
+    int choice;
+    verify_input(choice, "Select difficulty [1 - easy | 2 - medium | 3 - hard]: ", 1, 3);
+    return choice - 1;
+}
+
+/**
+ * @brief Retrieves the board preset chosen by the player.
+ * 
+ * @return One of the standard presets or `Preset::Custom` when the player wants to
+ * provide the dimensions by hand.
+ */
+
+Preset Player::choose_preset() {
+    int choice;
+    verify_input(choice, "Select board [1 - beginner 9x9 | 2 - intermediate 16x16 | 3 - expert 30x16 | 4 - custom | 5 - competitive vs bots]: ", 1, 5);
+    switch (choice) {
+        case 1:
+            return Preset::Beginner;
+        case 2:
+            return Preset::Intermediate;
+        case 3:
+            return Preset::Expert;
+        case 5:
+            return Preset::Competitive;
+        default:
+            return Preset::Custom;
+    }
+}
+
 /**
  * @brief Retrieves if player wants to play again.
+ * 
+ * Reads whole lines, so the answers read ahead during the game are used as well.
+ * The end of input ends the game.
  */
 
 bool Player::play_again() {
-    std::string play_again;
-    std::cout << "Play again? [y - yes | n - no]: " ;
-    std::cin >> play_again;
-    while (true) {
+    std::string line;
+    std::cout << "Play again? [y - yes | n - no]: " << std::flush;
+    while (read_line(line)) {
+        std::string play_again;
+        std::istringstream(line) >> play_again;
+        if (play_again.empty()) {
+            continue;
+        }
         if (play_again == "n") {
             return false;
         }
         if (play_again == "y") {
             return true;
         }
-        std::cout << "Provide y or n to continue: ";
-        std::cin >> play_again;
+        std::cout << "Provide y or n to continue: " << std::flush;
     }
+    return false;
 }
@@ -6,8 +6,25 @@
 #ifndef PLAYER_H
 #define PLAYER_H
 
+#include <deque>
 #include <tuple>
 #include <string>
+#include <vector>
+
+#include "keyboard.h"
+#include "topology.h"
+
+/**
+ * @brief Board presets offered before the game starts.
+*/
+
+enum class Preset {
+    Beginner,
+    Intermediate,
+    Expert,
+    Custom,
+    Competitive
+};
 
 /**
  * @class `Player`
@@ -17,10 +34,23 @@
 class Player {
 private:
     bool first_move = true;
+    int cursor_row = 0;
+    int cursor_column = 0;
+    std::deque<std::string> unread;
+    bool read_line(std::string& line);
 public:
-    std::tuple<int, int, int> player_move(int board_x, int board_y);
+    void new_game();
+    void start_at(int row, int column);
+    void unread_lines(const std::vector<std::string>& lines);
+    bool has_unread() const;
+    bool key_move(Key key, std::tuple<int, int, int>& move, int board_x, int board_y, int max_mode);
+    bool read_moves(std::vector<std::tuple<int, int, int>>& moves, int board_x, int board_y, int max_mode,
+                    std::string& error, std::string& line);
     bool verify_input(int& input, const std::string& prompt, int min, int max);
-    std::tuple<int, int> get_board_dimensions();
+    std::tuple<int, int> get_board_dimensions(int max_size);
+    Preset choose_preset();
+    Shape choose_shape();
+    int choose_difficulty();
     bool play_again();
 };
 
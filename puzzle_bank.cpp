@@ -0,0 +1,299 @@
+/**
+ * @file puzzle_bank.cpp
+ * @brief Implementation of `PuzzleBank` class and related functionalities.
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <tuple>
+
+#ifdef _WIN32
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "puzzle_bank.h"
+
+/**
+ * @brief Unmaps the bank file.
+ */
+
+PuzzleBank::~PuzzleBank() {
+    close();
+}
+
+/**
+ * @brief Maps the bank file into memory and validates its index.
+ *
+ * @param path Path of the bank file.
+ * The index has to be sorted and every bucket has to lie between the index and the end of the file.
+ *
+ * @return false if the file does not exist or is not a valid bank, the game then generates boards itself.
+ */
+
+bool PuzzleBank::open(const std::string& path) {
+    close();
+#ifdef _WIN32
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    contents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    data = contents.data();
+    size = contents.size();
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(Header))) {
+        ::close(fd);
+        return false;
+    }
+    void* mapping = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+    data = static_cast<const unsigned char*>(mapping);
+    size = info.st_size;
+#endif
+    const Header* header = reinterpret_cast<const Header*>(data);
+    bool valid = size >= sizeof(Header) && std::memcmp(header->magic, "MSPB", 4) == 0 && header->version == version
+                 && size >= sizeof(Header) + static_cast<std::size_t>(header->bucket_amount) * sizeof(Bucket);
+    const std::uint64_t entries_start = sizeof(Header) + static_cast<std::uint64_t>(header->bucket_amount) * sizeof(Bucket);
+    for (std::uint32_t i = 0; valid && i < bucket_amount(); ++i) {
+        const Bucket& bucket = buckets()[i];
+        valid = bucket.width && bucket.height && bucket.entry_size == entry_size(bucket.width, bucket.height)
+                && bucket.offset >= entries_start && bucket.offset <= size
+                && static_cast<std::uint64_t>(bucket.entry_amount) * bucket.entry_size <= size - bucket.offset
+                && (i == 0 || key(buckets()[i - 1]) < key(bucket));
+    }
+    if (!valid) {
+        close();
+    }
+    return valid;
+}
+
+/**
+ * @brief Checks if a valid bank file is mapped.
+ */
+
+bool PuzzleBank::is_open() const {
+    return data != nullptr;
+}
+
+/**
+ * @brief Releases the mapped file.
+ */
+
+void PuzzleBank::close() {
+#ifdef _WIN32
+    contents.clear();
+#else
+    if (data) {
+        munmap(const_cast<unsigned char*>(data), size);
+    }
+#endif
+    data = nullptr;
+    size = 0;
+}
+
+/**
+ * @brief Gets the index records which follow the header.
+ */
+
+const PuzzleBank::Bucket* PuzzleBank::buckets() const {
+    return reinterpret_cast<const Bucket*>(data + sizeof(Header));
+}
+
+/**
+ * @brief Gets the number of index records.
+ */
+
+std::uint32_t PuzzleBank::bucket_amount() const {
+    return data ? reinterpret_cast<const Header*>(data)->bucket_amount : 0;
+}
+
+/**
+ * @brief Picks a random board of the given size and difficulty.
+ *
+ * The sorted index is binary searched for the bucket of this key, then one of its entries is
+ * chosen at random. The entry is checked before it is used: its first click has to lie on the
+ * board and must not be a bomb.
+ *
+ * @param width Width of the board.
+ * @param height Height of the board.
+ * @param bombs Number of bombs on the board.
+ * @param difficulty Difficulty of the board, from 0 (easy) to 2 (hard).
+ * @param puzzle Reference where the board will be stored.
+ * @return false if the bank holds no such board or the chosen entry is corrupt.
+ */
+
+bool PuzzleBank::pick(int width, int height, int bombs, int difficulty, Puzzle& puzzle) {
+    const Bucket* first = buckets();
+    const Bucket* last = first + bucket_amount();
+    Bucket wanted{};
+    wanted.width = static_cast<std::uint16_t>(width);
+    wanted.height = static_cast<std::uint16_t>(height);
+    wanted.bombs = static_cast<std::uint16_t>(bombs);
+    wanted.difficulty = static_cast<std::uint8_t>(difficulty);
+    const Bucket* chosen = std::lower_bound(first, last, wanted,
+                                            [](const Bucket& a, const Bucket& b) { return key(a) < key(b); });
+    if (chosen == last || key(*chosen) != key(wanted) || !chosen->entry_amount) {
+        return false;
+    }
+    const unsigned char* entry = data + chosen->offset
+                                 + static_cast<std::size_t>(rng.get_random_number(0, chosen->entry_amount - 1)) * chosen->entry_size;
+    const Entry* header = reinterpret_cast<const Entry*>(entry);
+    const std::uint8_t* mines = entry + sizeof(Entry);
+    const int first_index = header->first_x * width + header->first_y;
+    if (header->first_x >= height || header->first_y >= width || ((mines[first_index >> 3] >> (first_index & 7)) & 1)) {
+        return false;
+    }
+    puzzle.first_x = header->first_x;
+    puzzle.first_y = header->first_y;
+    puzzle.bbbv = static_cast<int>(header->bbbv);
+    puzzle.difficulty = chosen->difficulty;
+    puzzle.mines = mines;
+    return true;
+}
+
+/**
+ * @brief Gets the size of a bank entry for a board, the bitmap is padded to 8 bytes.
+ */
+
+std::size_t PuzzleBank::entry_size(int width, int height) {
+    return sizeof(Entry) + (static_cast<std::size_t>(width) * height + 63) / 64 * 8;
+}
+
+/**
+ * @brief Counts the 3BV of a board, the minimal number of clicks needed to clear it.
+ *
+ * Every opening (a connected region of cells without bombs around, together with its border)
+ * counts as one click, every other cell without a bomb which is not on such a border counts as one.
+ *
+ * @param width Width of the board.
+ * @param height Height of the board.
+ * @param mines Mine bitmap, one bit per cell row by row.
+ * @return 3BV of the board.
+ */
+
+int PuzzleBank::count_3bv(int width, int height, const std::uint8_t* mines) {
+    auto is_mine = [&](int index) { return (mines[index >> 3] >> (index & 7)) & 1; };
+    const int size = width * height;
+    std::vector<std::uint8_t> around(size, 0);
+    for (int row = 0; row < height; ++row) {
+        for (int column = 0; column < width; ++column) {
+            for (int i = std::max(0, row - 1); i < std::min(height, row + 2); ++i) {
+                for (int j = std::max(0, column - 1); j < std::min(width, column + 2); ++j) {
+                    around[row * width + column] += is_mine(i * width + j);
+                }
+            }
+        }
+    }
+    std::vector<bool> visited(size, false);
+    std::vector<int> pending;
+    int bbbv = 0;
+    for (int start = 0; start < size; ++start) {
+        if (visited[start] || is_mine(start) || around[start]) {
+            continue;
+        }
+        bbbv++;
+        visited[start] = true;
+        pending.push_back(start);
+        while (!pending.empty()) {
+            const int center = pending.back();
+            pending.pop_back();
+            const int row = center / width;
+            const int column = center % width;
+            for (int i = std::max(0, row - 1); i < std::min(height, row + 2); ++i) {
+                for (int j = std::max(0, column - 1); j < std::min(width, column + 2); ++j) {
+                    const int next = i * width + j;
+                    if (!visited[next] && !is_mine(next)) {
+                        visited[next] = true;
+                        if (!around[next]) {
+                            pending.push_back(next);
+                        }
+                    }
+                }
+            }
+        }
+    }
+    for (int index = 0; index < size; ++index) {
+        if (!visited[index] && !is_mine(index)) {
+            bbbv++;
+        }
+    }
+    return bbbv;
+}
+
+/**
+ * @brief Writes a new bank file.
+ *
+ * The boards are grouped into buckets by size, bomb amount and difficulty and the
+ * index is sorted by that key. The file is written next to the target and renamed
+ * over it at the end, so a running game never maps a half written bank.
+ *
+ * @param path Path of the bank file.
+ * @param puzzles Generated boards.
+ * @return false if the file could not be written.
+ */
+
+bool PuzzleBank::write(const std::string& path, std::vector<GeneratedPuzzle> puzzles) {
+    auto key = [](const GeneratedPuzzle& puzzle) {
+        return std::make_tuple(puzzle.width, puzzle.height, puzzle.bombs, puzzle.difficulty);
+    };
+    std::stable_sort(puzzles.begin(), puzzles.end(),
+                     [&](const GeneratedPuzzle& a, const GeneratedPuzzle& b) { return key(a) < key(b); });
+    std::vector<Bucket> index;
+    for (const GeneratedPuzzle& puzzle : puzzles) {
+        if (index.empty() || std::make_tuple(index.back().width, index.back().height, index.back().bombs, index.back().difficulty)
+                             != std::make_tuple(puzzle.width, puzzle.height, puzzle.bombs, puzzle.difficulty)) {
+            Bucket bucket{};
+            bucket.width = static_cast<std::uint16_t>(puzzle.width);
+            bucket.height = static_cast<std::uint16_t>(puzzle.height);
+            bucket.bombs = static_cast<std::uint16_t>(puzzle.bombs);
+            bucket.difficulty = static_cast<std::uint8_t>(puzzle.difficulty);
+            bucket.entry_size = static_cast<std::uint32_t>(entry_size(puzzle.width, puzzle.height));
+            index.push_back(bucket);
+        }
+        index.back().entry_amount++;
+    }
+    std::uint64_t offset = sizeof(Header) + index.size() * sizeof(Bucket);
+    for (Bucket& bucket : index) {
+        bucket.offset = offset;
+        offset += static_cast<std::uint64_t>(bucket.entry_amount) * bucket.entry_size;
+    }
+
+    const std::string temporary = path + ".tmp";
+    std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+    Header header{{'M', 'S', 'P', 'B'}, version, static_cast<std::uint32_t>(index.size()), 0};
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(index.data()), index.size() * sizeof(Bucket));
+    for (const GeneratedPuzzle& puzzle : puzzles) {
+        std::vector<char> entry(entry_size(puzzle.width, puzzle.height), 0);
+        Entry fields{static_cast<std::uint16_t>(puzzle.first_x), static_cast<std::uint16_t>(puzzle.first_y),
+                     static_cast<std::uint32_t>(puzzle.bbbv)};
+        std::memcpy(entry.data(), &fields, sizeof(fields));
+        std::memcpy(entry.data() + sizeof(fields), puzzle.mines.data(),
+                    std::min(puzzle.mines.size(), entry.size() - sizeof(fields)));
+        file.write(entry.data(), entry.size());
+    }
+    file.close();
+    if (!file) {
+        std::remove(temporary.c_str());
+        return false;
+    }
+#ifdef _WIN32
+    std::remove(path.c_str());
+#endif
+    return std::rename(temporary.c_str(), path.c_str()) == 0;
+}
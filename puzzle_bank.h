@@ -0,0 +1,107 @@
+/**
+ * @file puzzle_bank.h
+ * @brief Class reading pre-generated boards from a memory mapped bank file.
+ */
+
+#ifndef PUZZLE_BANK_H
+#define PUZZLE_BANK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "randomizer.h"
+
+/**
+ * @class PuzzleBank
+ * @brief A read-only bank of boards generated offline by `tools/generate_puzzle_bank.cpp`.
+ *
+ * @details The file starts with a `Header`, followed by a sorted index of `Bucket` records keyed by
+ * size, bomb amount and difficulty. Every bucket points to a block of fixed size entries: the safe
+ * first click, the 3BV of the board and the mine bitmap (one bit per cell, row by row). The file is
+ * memory mapped, so picking a board costs an index lookup and the page faults of a single entry.
+ * The index is validated when the file is opened, every entry when it is picked.
+ */
+
+class PuzzleBank {
+public:
+    static constexpr const char* default_path = "puzzles.bank";
+    static constexpr std::uint32_t version = 1;
+
+    struct Header {
+        char magic[4];
+        std::uint32_t version;
+        std::uint32_t bucket_amount;
+        std::uint32_t reserved;
+    };
+
+    struct Bucket {
+        std::uint16_t width;
+        std::uint16_t height;
+        std::uint16_t bombs;
+        std::uint8_t difficulty;
+        std::uint8_t reserved;
+        std::uint32_t entry_amount;
+        std::uint32_t entry_size;
+        std::uint64_t offset;
+    };
+
+    struct Entry {
+        std::uint16_t first_x;
+        std::uint16_t first_y;
+        std::uint32_t bbbv;
+    };
+
+    /**
+     * @brief Board taken from the bank, `mines` points into the mapped file.
+     */
+    struct Puzzle {
+        int first_x;
+        int first_y;
+        int bbbv;
+        int difficulty;
+        const std::uint8_t* mines;
+    };
+
+    /**
+     * @brief Board produced by the generator before it is written to the bank.
+     */
+    struct GeneratedPuzzle {
+        int width;
+        int height;
+        int bombs;
+        int difficulty;
+        int first_x;
+        int first_y;
+        int bbbv;
+        std::vector<std::uint8_t> mines;
+    };
+private:
+    const unsigned char* data = nullptr;
+    std::size_t size = 0;
+#ifdef _WIN32
+    std::vector<unsigned char> contents;
+#endif
+    RandomNumberGenerator rng;
+    static std::tuple<int, int, int, int> key(const Bucket& bucket) {
+        return std::make_tuple(bucket.width, bucket.height, bucket.bombs, bucket.difficulty);
+    }
+    const Bucket* buckets() const;
+    std::uint32_t bucket_amount() const;
+public:
+    PuzzleBank() = default;
+    ~PuzzleBank();
+    PuzzleBank(const PuzzleBank&) = delete;
+    PuzzleBank& operator=(const PuzzleBank&) = delete;
+    bool open(const std::string& path);
+    void close();
+    bool is_open() const;
+    bool pick(int width, int height, int bombs, int difficulty, Puzzle& puzzle);
+    static std::size_t entry_size(int width, int height);
+    static int count_3bv(int width, int height, const std::uint8_t* mines);
+    static bool write(const std::string& path, std::vector<GeneratedPuzzle> puzzles);
+};
+
+#endif //PUZZLE_BANK_H
@@ -0,0 +1,163 @@
+/**
+ * @file renderer.cpp
+ * @brief Implementation of `Renderer` class and related functionalities.
+*/
+
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <utility>
+
+#include "renderer.h"
+
+/**
+ * @brief Constructs a new Renderer object.
+ *
+ * @param gui GUI used to clear the terminal before drawing a frame.
+ */
+
+Renderer::Renderer(const GUI& gui) : gui(gui) {}
+
+/**
+ * @brief Stops the render thread if it is still running.
+ */
+
+Renderer::~Renderer() {
+    stop();
+}
+
+/**
+ * @brief Starts the render thread.
+ */
+
+void Renderer::start() {
+    stopping = false;
+    worker = std::thread(&Renderer::run, this);
+}
+
+/**
+ * @brief Draws the last pending frame and stops the render thread.
+ */
+
+void Renderer::stop() {
+    if (!worker.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    changed.notify_one();
+    worker.join();
+}
+
+/**
+ * @brief Replaces the pending frame.
+ *
+ * If the previous frame has not been drawn yet it is dropped.
+ *
+ * @param new_frame Screen prepared by the game logic.
+ */
+
+void Renderer::submit_frame(Frame new_frame) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (dirty) {
+            frames_skipped++;
+        }
+        frame = std::move(new_frame);
+        dirty = true;
+    }
+    changed.notify_one();
+}
+
+/**
+ * @brief Replaces the pending frame which shows the result of an input.
+ *
+ * When frames are coalesced the earliest input time is kept, so the measured
+ * latency covers the oldest input shown by the frame.
+ *
+ * @param new_frame Screen prepared by the game logic.
+ * @param received Time at which the input was read.
+ */
+
+void Renderer::submit_frame(Frame new_frame, Clock::time_point received) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!has_input) {
+            input_time = received;
+            has_input = true;
+        }
+    }
+    submit_frame(std::move(new_frame));
+}
+
+/**
+ * @brief Replaces the message displayed below the current board.
+ *
+ * Used by the input stage to report rejected lines.
+ */
+
+void Renderer::set_status(const std::string& new_status) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        frame.status = new_status;
+        dirty = true;
+    }
+    changed.notify_one();
+}
+
+/**
+ * @brief Builds a summary of frame and latency counters.
+ *
+ * @return Human readable report.
+ */
+
+std::string Renderer::latency_report() {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::ostringstream report;
+    report << std::fixed << std::setprecision(2);
+    report << "Frames drawn: " << frames_drawn << ", skipped: " << frames_skipped << std::endl;
+    if (latency_samples) {
+        report << "Input-to-screen latency [ms]: last " << last_latency
+               << ", average " << total_latency / latency_samples
+               << ", max " << max_latency << std::endl;
+    }
+    return report.str();
+}
+
+/**
+ * @brief Main loop of the render thread.
+ *
+ * Waits for a change, copies the newest frame and writes it to the terminal
+ * without holding the lock, so the game logic never waits on terminal output.
+ */
+
+void Renderer::run() {
+    while (true) {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [this] { return dirty || stopping; });
+        if (!dirty) {
+            break;
+        }
+        std::string output = frame.board + frame.status + "\n" + frame.prompt;
+        bool measured = has_input;
+        Clock::time_point received = input_time;
+        has_input = false;
+        dirty = false;
+        lock.unlock();
+
+        gui.clear_terminal();
+        std::cout << output << std::flush;
+
+        lock.lock();
+        frames_drawn++;
+        if (measured) {
+            last_latency = std::chrono::duration<double, std::milli>(Clock::now() - received).count();
+            total_latency += last_latency;
+            max_latency = std::max(max_latency, last_latency);
+            latency_samples++;
+        }
+    }
+}
@@ -0,0 +1,67 @@
+/**
+ * @file renderer.h
+ * @brief Class drawing frames to the terminal on its own thread.
+ */
+
+#ifndef RENDERER_H
+#define RENDERER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "gui.h"
+
+/**
+ * @class Renderer
+ * @brief A render stage which owns all terminal output during a game.
+ *
+ * @details Frames are prepared in memory by the game logic and handed over with `submit_frame`.
+ * Only the newest pending frame is kept, so several state changes submitted while the terminal
+ * is busy are coalesced into a single redraw and stale frames are skipped. The renderer also
+ * measures the time between receiving an input and showing the frame containing its result.
+ */
+
+class Renderer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Contents of the screen: the board, a status line and the input prompt.
+     */
+    struct Frame {
+        std::string board;
+        std::string status;
+        std::string prompt;
+    };
+private:
+    const GUI& gui;
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::thread worker;
+    Frame frame;
+    bool dirty = false;
+    bool stopping = false;
+    bool has_input = false;
+    Clock::time_point input_time;
+    int frames_drawn = 0;
+    int frames_skipped = 0;
+    int latency_samples = 0;
+    double last_latency = 0.0;
+    double total_latency = 0.0;
+    double max_latency = 0.0;
+    void run();
+public:
+    explicit Renderer(const GUI& gui);
+    ~Renderer();
+    void start();
+    void stop();
+    void submit_frame(Frame new_frame);
+    void submit_frame(Frame new_frame, Clock::time_point received);
+    void set_status(const std::string& new_status);
+    std::string latency_report();
+};
+
+#endif //RENDERER_H
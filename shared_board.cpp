@@ -0,0 +1,327 @@
+/**
+ * @file shared_board.cpp
+ * @brief Implementation of `SharedBoard` class and related functionalities.
+ */
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "shared_board.h"
+
+/**
+ * @brief Constructs a new SharedBoard object with all cells covered.
+ *
+ * @param w Width of the board.
+ * @param h Height of the board.
+ * @param bombs Number of bombs to place on the board.
+ */
+
+SharedBoard::SharedBoard(int w, int h, int bombs)
+    : width(w), height(h), bomb_amount(bombs),
+      mines((w * h + 63) / 64), revealed((w * h + 63) / 64), flagged((w * h + 63) / 64),
+      bombs_around(w * h) {}
+
+/**
+ * @brief Places bombs randomly on the board.
+ *
+ * Must be called before the players start. Ensures that bombs are not placed on
+ * or around the first cell chosen by the player.
+ *
+ * @param first_x Row of the first move.
+ * @param first_y Column of the first move.
+ */
+
+void SharedBoard::place_bombs(int first_x, int first_y) {
+    int changed = 0;
+    while (changed < bomb_amount) {
+        int row = rng.get_random_number(0, height - 1);
+        int column = rng.get_random_number(0, width - 1);
+        int index = row * width + column;
+        if (std::abs(row - first_x) <= 1 && std::abs(column - first_y) <= 1) {
+            continue;
+        }
+        if (!test(mines[index >> 6], index)) {
+            mines[index >> 6] |= std::uint64_t{1} << (index & 63);
+            changed++;
+        }
+    }
+}
+
+/**
+ * @brief Counts the bombs around every cell of the board.
+ *
+ * Must be called after `place_bombs` and before the players start.
+ */
+
+void SharedBoard::count_bombs() {
+    for (int row = 0; row < height; ++row) {
+        for (int column = 0; column < width; ++column) {
+            int counter = 0;
+            for (int i = std::max(0, row - 1); i < std::min(height, row + 2); ++i) {
+                for (int j = std::max(0, column - 1); j < std::min(width, column + 2); ++j) {
+                    int index = i * width + j;
+                    counter += test(mines[index >> 6], index);
+                }
+            }
+            int index = row * width + column;
+            bombs_around[index] = static_cast<std::uint8_t>(counter - test(mines[index >> 6], index));
+        }
+    }
+}
+
+/**
+ * @brief Tries to set the revealed bit of a cell with compare-and-swap.
+ *
+ * @param index Index of the cell.
+ * @return true if this call revealed the cell, false if it already was revealed.
+ */
+
+bool SharedBoard::claim(int index) {
+    std::atomic<std::uint64_t>& word = revealed[index >> 6];
+    const std::uint64_t bit = std::uint64_t{1} << (index & 63);
+    std::uint64_t current = word.load(std::memory_order_relaxed);
+    while (!(current & bit)) {
+        if (word.compare_exchange_weak(current, current | bit, std::memory_order_acq_rel)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Adds revealed cells to the score of a player.
+ */
+
+void SharedBoard::credit(int player, int cells) {
+    revealed_amount.fetch_add(cells, std::memory_order_relaxed);
+    scores[player].fetch_add(cells, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Reveals a cell and, if it has no bombs around, the whole empty region.
+ *
+ * Only cells revealed by this call are expanded and credited to the player,
+ * so concurrent cascades over the same region split it without overlap.
+ *
+ * @param row Row of the cell.
+ * @param column Column of the cell.
+ * @param player Index of the player making the move.
+ * @return Number of cells credited to the player, -1 if the cell is a bomb. The bomb stays covered for the other players.
+ */
+
+int SharedBoard::reveal(int row, int column, int player) {
+    const int start = row * width + column;
+    if (test(flagged[start >> 6].load(std::memory_order_relaxed), start)) {
+        return 0;
+    }
+    if (test(mines[start >> 6], start)) {
+        return -1;
+    }
+    if (!claim(start)) {
+        return 0;
+    }
+    int cells = 1;
+    std::vector<int> pending;
+    if (!bombs_around[start]) {
+        pending.push_back(start);
+    }
+    while (!pending.empty()) {
+        const int center = pending.back();
+        pending.pop_back();
+        const int center_row = center / width;
+        const int center_column = center % width;
+        for (int i = std::max(0, center_row - 1); i < std::min(height, center_row + 2); ++i) {
+            for (int j = std::max(0, center_column - 1); j < std::min(width, center_column + 2); ++j) {
+                const int next = i * width + j;
+                if (!test(mines[next >> 6], next) && claim(next)) {
+                    cells++;
+                    if (!bombs_around[next]) {
+                        pending.push_back(next);
+                    }
+                }
+            }
+        }
+    }
+    credit(player, cells);
+    return cells;
+}
+
+/**
+ * @brief Reveals all unflagged neighbours of a number whose flag count matches it.
+ *
+ * @param row Row of the cell.
+ * @param column Column of the cell.
+ * @param player Index of the player making the move.
+ * @return Number of cells credited to the player, -1 if a bomb has been revealed.
+ */
+
+int SharedBoard::chord(int row, int column, int player) {
+    if (!is_revealed(row, column) || !get_bombs_around(row, column)) {
+        return 0;
+    }
+    int flags = 0;
+    for (int i = std::max(0, row - 1); i < std::min(height, row + 2); ++i) {
+        for (int j = std::max(0, column - 1); j < std::min(width, column + 2); ++j) {
+            flags += is_flagged(i, j);
+        }
+    }
+    if (flags != get_bombs_around(row, column)) {
+        return 0;
+    }
+    int cells = 0;
+    bool hit = false;
+    for (int i = std::max(0, row - 1); i < std::min(height, row + 2); ++i) {
+        for (int j = std::max(0, column - 1); j < std::min(width, column + 2); ++j) {
+            int result = reveal(i, j, player);
+            if (result < 0) {
+                hit = true;
+            } else {
+                cells += result;
+            }
+        }
+    }
+    return hit ? -1 : cells;
+}
+
+/**
+ * @brief Toggles the flag of a covered cell.
+ */
+
+void SharedBoard::toggle_flag(int row, int column) {
+    const int index = row * width + column;
+    if (!is_revealed(row, column)) {
+        flagged[index >> 6].fetch_xor(std::uint64_t{1} << (index & 63), std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Reveals all cells on the board when the game is over, scores are not changed.
+ */
+
+void SharedBoard::reveal_all() {
+    for (auto& word : revealed) {
+        word.store(~std::uint64_t{0}, std::memory_order_release);
+    }
+}
+
+/**
+ * @brief Checks if the cell has been revealed.
+ */
+
+bool SharedBoard::is_revealed(int row, int column) const {
+    const int index = row * width + column;
+    return test(revealed[index >> 6].load(std::memory_order_acquire), index);
+}
+
+/**
+ * @brief Checks if the cell has been flagged.
+ */
+
+bool SharedBoard::is_flagged(int row, int column) const {
+    const int index = row * width + column;
+    return test(flagged[index >> 6].load(std::memory_order_relaxed), index);
+}
+
+/**
+ * @brief Checks if all cells without bombs have been revealed.
+ */
+
+bool SharedBoard::is_cleared() const {
+    return revealed_amount.load(std::memory_order_relaxed) == width * height - bomb_amount;
+}
+
+/**
+ * @brief Lists the cells revealed, flagged or unflagged since the previous call.
+ *
+ * Compares the bit planes with the copy kept by the caller a word at a time, so only the changed
+ * words are looked at bit by bit. The other players may keep moving, their later changes are
+ * found by the next call.
+ *
+ * @param seen Planes seen by the previous call, empty for a board which has not been looked at yet.
+ * Updated to the current planes.
+ * @param changed Vector the indices (`row * width + column`) of the changed cells are appended to.
+ */
+
+void SharedBoard::collect_changed(std::vector<std::uint64_t>& seen, std::vector<int>& changed) const {
+    const std::size_t words = revealed.size();
+    const int size = width * height;
+    seen.resize(2 * words, 0);
+    for (std::size_t word = 0; word < words; ++word) {
+        const std::uint64_t revealed_word = revealed[word].load(std::memory_order_acquire);
+        const std::uint64_t flagged_word = flagged[word].load(std::memory_order_relaxed);
+        std::uint64_t difference = (revealed_word ^ seen[2 * word]) | (flagged_word ^ seen[2 * word + 1]);
+        seen[2 * word] = revealed_word;
+        seen[2 * word + 1] = flagged_word;
+        for (int index = static_cast<int>(word * 64); difference && index < size; ++index, difference >>= 1) {
+            if (difference & 1) {
+                changed.push_back(index);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Gets the number of bombs around the cell.
+ */
+
+int SharedBoard::get_bombs_around(int row, int column) const {
+    return bombs_around[row * width + column];
+}
+
+/**
+ * @brief Gets the number of cells revealed by a player.
+ */
+
+int SharedBoard::get_score(int player) const {
+    return scores[player].load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Builds a snapshot of the cell, used for printing the board.
+ *
+ * @param row Row of the cell.
+ * @param col Column of the cell.
+ * @return Copy of the cell state.
+ */
+
+Cell SharedBoard::get_cell(int row, int col) const {
+    Cell cell;
+    const int index = row * width + col;
+    if (test(mines[index >> 6], index)) {
+        cell.mark_as_bomb();
+    }
+    for (int i = 0; i < bombs_around[index]; ++i) {
+        cell.update_counter();
+    }
+    if (is_revealed(row, col)) {
+        cell.reveal();
+    }
+    if (is_flagged(row, col)) {
+        cell.flag_bomb();
+    }
+    return cell;
+}
+
+/**
+ * @brief Gets the width of the board.
+ */
+
+int SharedBoard::get_width() const {
+    return width;
+}
+
+/**
+ * @brief Gets the height of the board.
+ */
+
+int SharedBoard::get_height() const {
+    return height;
+}
+
+/**
+ * @brief Gets the shape of the board, competitive boards are always rectangular.
+ */
+
+Shape SharedBoard::get_shape() const {
+    return Shape::Rectangle;
+}
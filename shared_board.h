@@ -0,0 +1,67 @@
+/**
+ * @file shared_board.h
+ * @brief Class representing board shared by several players acting at the same time.
+ */
+
+#ifndef SHARED_BOARD_H
+#define SHARED_BOARD_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "cell.h"
+#include "randomizer.h"
+#include "topology.h"
+
+/**
+ * @class SharedBoard
+ * @brief A board used by the competitive mode, safe to use from many threads without locks.
+ *
+ * @details The state is kept in bit planes of 64-bit words. The mine plane and the counters are
+ * written once before the players start and are read-only afterwards. The revealed and flagged
+ * planes are atomic: a cell is revealed by the thread whose atomic update sets its bit, so every
+ * cell is credited to exactly one player and cascades started by different players never expand
+ * the same cell twice.
+ */
+
+class SharedBoard {
+public:
+    static constexpr int max_players = 16;
+    static constexpr int max_size = 1000;
+private:
+    int width;
+    int height;
+    int bomb_amount;
+    std::vector<std::uint64_t> mines;
+    std::vector<std::atomic<std::uint64_t>> revealed;
+    std::vector<std::atomic<std::uint64_t>> flagged;
+    std::vector<std::uint8_t> bombs_around;
+    std::atomic<int> revealed_amount{0};
+    std::array<std::atomic<int>, max_players> scores{};
+    RandomNumberGenerator rng;
+    static bool test(std::uint64_t word, int index) { return (word >> (index & 63)) & 1; }
+    bool claim(int index);
+    void credit(int player, int cells);
+public:
+    SharedBoard(int w, int h, int bombs);
+    void place_bombs(int first_x, int first_y);
+    void count_bombs();
+    int reveal(int row, int column, int player);
+    int chord(int row, int column, int player);
+    void toggle_flag(int row, int column);
+    void reveal_all();
+    bool is_revealed(int row, int column) const;
+    bool is_flagged(int row, int column) const;
+    bool is_cleared() const;
+    void collect_changed(std::vector<std::uint64_t>& seen, std::vector<int>& changed) const;
+    int get_bombs_around(int row, int column) const;
+    int get_score(int player) const;
+    Cell get_cell(int row, int col) const;
+    int get_width() const;
+    int get_height() const;
+    Shape get_shape() const;
+};
+
+#endif //SHARED_BOARD_H
@@ -0,0 +1,525 @@
+/**
+ * @file spectator_feed.cpp
+ * @brief Implementation of `SpectatorFeed` and `SpectatorDecoder` classes.
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#ifndef _WIN32
+#include <csignal>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include "spectator_feed.h"
+
+/**
+ * @brief Appends an unsigned integer using 7 bits per byte.
+ */
+
+static void put_varint(std::vector<std::uint8_t>& out, std::uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<std::uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<std::uint8_t>(value));
+}
+
+/**
+ * @brief Reads an unsigned integer written by `put_varint`.
+ *
+ * @return false if the data ends before the integer does.
+ */
+
+static bool get_varint(const std::uint8_t*& data, const std::uint8_t* end, std::uint64_t& value) {
+    value = 0;
+    for (int shift = 0; data < end && shift < 64; shift += 7) {
+        std::uint8_t byte = *data++;
+        value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Closes the target.
+ */
+
+SpectatorFeed::~SpectatorFeed() {
+    close();
+}
+
+/**
+ * @brief Opens the target the games will be streamed to.
+ *
+ * Regular files are truncated. Named pipes need a reader to be opened, local sockets
+ * (`unix:<path>`) need a listening viewer. Not available on Windows.
+ *
+ * @param target Path of a file or named pipe, or `unix:` followed by the path of a socket.
+ * @return false if the target could not be opened.
+ */
+
+bool SpectatorFeed::open(const std::string& target) {
+    close();
+#ifdef _WIN32
+    (void)target;
+    return false;
+#else
+    const std::string socket_prefix = "unix:";
+    if (target.compare(0, socket_prefix.size(), socket_prefix) == 0) {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        std::strncpy(address.sun_path, target.c_str() + socket_prefix.size(), sizeof(address.sun_path) - 1);
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd >= 0 && connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            ::close(fd);
+            fd = -1;
+        }
+        stream = true;
+    } else {
+        struct stat info;
+        stream = stat(target.c_str(), &info) == 0 && S_ISFIFO(info.st_mode);
+        fd = stream ? ::open(target.c_str(), O_WRONLY | O_NONBLOCK)
+                    : ::open(target.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    }
+    if (fd < 0) {
+        return false;
+    }
+    if (stream) {
+        std::signal(SIGPIPE, SIG_IGN);
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    }
+    frame = 0;
+    need_keyframe = true;
+    return true;
+#endif
+}
+
+/**
+ * @brief Closes the target, further changes are ignored.
+ */
+
+void SpectatorFeed::close() {
+#ifndef _WIN32
+    if (fd >= 0) {
+        ::close(fd);
+    }
+#endif
+    fd = -1;
+    backlog.clear();
+}
+
+/**
+ * @brief Checks if the feed has an open target.
+ */
+
+bool SpectatorFeed::is_open() const {
+    return fd >= 0;
+}
+
+/**
+ * @brief Makes the next message a keyframe, called when a new game starts.
+ */
+
+void SpectatorFeed::start_game() {
+    need_keyframe = true;
+}
+
+/**
+ * @brief Sends the result of the game, called once after its last changes were published.
+ *
+ * Like any other message the result is dropped when a pipe or socket is full.
+ *
+ * @param result How the game ended.
+ */
+
+void SpectatorFeed::finish_game(GameResult result) {
+    if (fd < 0 || !flush_backlog()) {
+        return;
+    }
+    payload.clear();
+    payload.push_back('R');
+    put_varint(payload, frame);
+    payload.push_back(result);
+    send();
+}
+
+/**
+ * @brief Gets the spectator code of a cell.
+ */
+
+std::uint8_t SpectatorFeed::cell_code(const Cell& cell) {
+    if (cell.get_is_marked()) {
+        return code_flagged;
+    }
+    if (!cell.get_is_revealed()) {
+        return code_covered;
+    }
+    if (cell.get_is_bomb()) {
+        return code_mine;
+    }
+    return static_cast<std::uint8_t>(cell.get_bombs_around());
+}
+
+/**
+ * @brief Encodes and sends the codes prepared in `current`.
+ *
+ * @param new_width Width of the board.
+ * @param new_height Height of the board.
+ */
+
+void SpectatorFeed::publish_codes(int new_width, int new_height) {
+    if (!flush_backlog()) {
+        need_keyframe = true;
+        return;
+    }
+    if (need_keyframe || new_width != width || new_height != height || frame % keyframe_interval == 0) {
+        width = new_width;
+        height = new_height;
+        encode_keyframe();
+    } else if (!encode_delta()) {
+        return;
+    }
+    send();
+    previous.swap(current);
+}
+
+/**
+ * @brief Encodes and sends the cells prepared in `updates`.
+ */
+
+void SpectatorFeed::publish_updates() {
+    if (!flush_backlog()) {
+        need_keyframe = true;
+        return;
+    }
+    if (encode_updates()) {
+        send();
+    }
+}
+
+/**
+ * @brief Encodes all cells as runs of equal codes.
+ */
+
+void SpectatorFeed::encode_keyframe() {
+    payload.clear();
+    payload.push_back('K');
+    put_varint(payload, frame);
+    put_varint(payload, width);
+    put_varint(payload, height);
+    const std::size_t size = current.size();
+    for (std::size_t i = 0; i < size;) {
+        std::size_t j = i;
+        while (j < size && current[j] == current[i]) {
+            j++;
+        }
+        put_varint(payload, j - i);
+        payload.push_back(current[i]);
+        i = j;
+    }
+    need_keyframe = false;
+}
+
+/**
+ * @brief Encodes the runs of cells which changed since the previous message.
+ *
+ * @return false if nothing has changed.
+ */
+
+bool SpectatorFeed::encode_delta() {
+    payload.clear();
+    payload.push_back('D');
+    put_varint(payload, frame);
+    const std::size_t size = current.size();
+    std::size_t last_end = 0;
+    bool changed = false;
+    for (std::size_t i = 0; i < size;) {
+        if (current[i] == previous[i]) {
+            i++;
+            continue;
+        }
+        std::size_t j = i;
+        while (j < size && current[j] != previous[j]) {
+            j++;
+        }
+        put_varint(payload, i - last_end);
+        put_varint(payload, j - i);
+        for (std::size_t k = i; k < j; k += 2) {
+            payload.push_back(static_cast<std::uint8_t>(current[k] | (k + 1 < j ? current[k + 1] << 4 : 0)));
+        }
+        last_end = j;
+        changed = true;
+        i = j;
+    }
+    put_varint(payload, 0);
+    put_varint(payload, 0);
+    return changed;
+}
+
+/**
+ * @brief Encodes a delta from the changed cells in `updates` and applies them to `previous`.
+ *
+ * The cells are sorted, so only cells whose code really differs are visited and the runs
+ * come out in the same format as from `encode_delta`.
+ *
+ * @return false if nothing has changed.
+ */
+
+bool SpectatorFeed::encode_updates() {
+    std::sort(updates.begin(), updates.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+    updates.erase(std::unique(updates.begin(), updates.end(),
+                              [](const auto& a, const auto& b) { return a.first == b.first; }), updates.end());
+    updates.erase(std::remove_if(updates.begin(), updates.end(),
+                                 [this](const auto& update) { return previous[update.first] == update.second; }),
+                  updates.end());
+    if (updates.empty()) {
+        return false;
+    }
+    payload.clear();
+    payload.push_back('D');
+    put_varint(payload, frame);
+    std::size_t last_end = 0;
+    for (std::size_t i = 0; i < updates.size();) {
+        std::size_t j = i + 1;
+        while (j < updates.size() && updates[j].first == updates[j - 1].first + 1) {
+            j++;
+        }
+        put_varint(payload, updates[i].first - last_end);
+        put_varint(payload, j - i);
+        for (std::size_t k = i; k < j; k += 2) {
+            payload.push_back(static_cast<std::uint8_t>(updates[k].second | (k + 1 < j ? updates[k + 1].second << 4 : 0)));
+        }
+        for (std::size_t k = i; k < j; ++k) {
+            previous[updates[k].first] = updates[k].second;
+        }
+        last_end = updates[j - 1].first + 1;
+        i = j;
+    }
+    put_varint(payload, 0);
+    put_varint(payload, 0);
+    return true;
+}
+
+/**
+ * @brief Writes the rest of a message which did not fit into a pipe or socket before.
+ *
+ * @return true if nothing is left to write.
+ */
+
+bool SpectatorFeed::flush_backlog() {
+#ifndef _WIN32
+    if (backlog.empty()) {
+        return true;
+    }
+    ssize_t written = write(fd, backlog.data(), backlog.size());
+    if (written > 0) {
+        backlog.erase(backlog.begin(), backlog.begin() + written);
+    } else if (written < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+        close();
+    }
+#endif
+    return backlog.empty();
+}
+
+/**
+ * @brief Writes the encoded message prefixed with its length.
+ *
+ * Files are written completely. On pipes and sockets a message which does not fit at all
+ * is dropped and a keyframe is sent next, a partially written one is kept in `backlog`.
+ */
+
+void SpectatorFeed::send() {
+#ifndef _WIN32
+    std::vector<std::uint8_t> message;
+    message.reserve(payload.size() + 5);
+    put_varint(message, payload.size());
+    message.insert(message.end(), payload.begin(), payload.end());
+    std::size_t offset = 0;
+    while (offset < message.size()) {
+        ssize_t written = write(fd, message.data() + offset, message.size() - offset);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            if (offset == 0) {
+                need_keyframe = true;
+                return;
+            }
+            backlog.assign(message.begin() + offset, message.end());
+            break;
+        }
+        if (written < 0) {
+            close();
+            return;
+        }
+        offset += written;
+        if (stream && offset < message.size()) {
+            backlog.assign(message.begin() + offset, message.end());
+            break;
+        }
+    }
+    frame++;
+#endif
+}
+
+/**
+ * @brief Feeds bytes of the stream to the decoder.
+ *
+ * @param data Bytes read from the stream.
+ * @param length Number of bytes.
+ * @return Number of messages applied.
+ */
+
+int SpectatorDecoder::feed(const std::uint8_t* data, std::size_t length) {
+    buffer.insert(buffer.end(), data, data + length);
+    const std::uint8_t* position = buffer.data();
+    const std::uint8_t* end = buffer.data() + buffer.size();
+    int applied = 0;
+    while (position < end) {
+        const std::uint8_t* message = position;
+        std::uint64_t size;
+        if (!get_varint(message, end, size) || static_cast<std::uint64_t>(end - message) < size) {
+            break;
+        }
+        applied += apply(message, size);
+        position = message + size;
+    }
+    buffer.erase(buffer.begin(), buffer.begin() + (position - buffer.data()));
+    return applied;
+}
+
+/**
+ * @brief Applies a single complete message.
+ *
+ * @return false if the message was skipped or malformed.
+ */
+
+bool SpectatorDecoder::apply(const std::uint8_t* message, std::size_t length) {
+    const std::uint8_t* end = message + length;
+    if (message == end) {
+        return false;
+    }
+    const std::uint8_t type = *message++;
+    std::uint64_t number;
+    if (!get_varint(message, end, number)) {
+        return false;
+    }
+    if (type == 'K') {
+        std::uint64_t new_width, new_height;
+        if (!get_varint(message, end, new_width) || !get_varint(message, end, new_height) ||
+            new_width > static_cast<std::uint64_t>(max_size) || new_height > static_cast<std::uint64_t>(max_size)) {
+            return false;
+        }
+        width = static_cast<int>(new_width);
+        height = static_cast<int>(new_height);
+        cells.assign(static_cast<std::size_t>(width) * height, code_covered);
+        std::size_t position = 0;
+        std::uint64_t run;
+        while (position < cells.size() && get_varint(message, end, run) && message < end) {
+            std::size_t stop = std::min<std::size_t>(cells.size(), position + run);
+            std::fill(cells.begin() + position, cells.begin() + stop, *message++);
+            position = stop;
+        }
+        result = result_playing;
+        keyframes++;
+    } else if (type == 'D') {
+        if (cells.empty()) {
+            return false;
+        }
+        std::size_t position = 0;
+        std::uint64_t gap, run;
+        while (get_varint(message, end, gap) && get_varint(message, end, run) && run) {
+            position += gap;
+            if (position + run > cells.size() || static_cast<std::uint64_t>(end - message) < (run + 1) / 2) {
+                return false;
+            }
+            for (std::uint64_t k = 0; k < run; ++k) {
+                cells[position + k] = (message[k / 2] >> (k % 2 ? 4 : 0)) & 0x0f;
+            }
+            message += (run + 1) / 2;
+            position += run;
+        }
+        deltas++;
+    } else if (type == 'R') {
+        if (cells.empty() || message == end || *message > result_quit) {
+            return false;
+        }
+        result = static_cast<GameResult>(*message);
+    } else {
+        return false;
+    }
+    frame = static_cast<std::uint32_t>(number);
+    return true;
+}
+
+/**
+ * @brief Gets the width of the decoded board.
+ */
+
+int SpectatorDecoder::get_width() const {
+    return width;
+}
+
+/**
+ * @brief Gets the height of the decoded board.
+ */
+
+int SpectatorDecoder::get_height() const {
+    return height;
+}
+
+/**
+ * @brief Gets the number of the last applied message.
+ */
+
+std::uint32_t SpectatorDecoder::get_frame() const {
+    return frame;
+}
+
+/**
+ * @brief Gets the number of applied keyframes.
+ */
+
+int SpectatorDecoder::get_keyframes() const {
+    return keyframes;
+}
+
+/**
+ * @brief Gets the number of applied deltas.
+ */
+
+int SpectatorDecoder::get_deltas() const {
+    return deltas;
+}
+
+/**
+ * @brief Gets the result of the game, `result_playing` until its result message arrives.
+ */
+
+GameResult SpectatorDecoder::get_result() const {
+    return result;
+}
+
+/**
+ * @brief Gets the code of a cell.
+ */
+
+std::uint8_t SpectatorDecoder::get_code(int row, int column) const {
+    return cells[static_cast<std::size_t>(row) * width + column];
+}
+
+/**
+ * @brief Counts the cells with the given code.
+ */
+
+int SpectatorDecoder::count(std::uint8_t code) const {
+    return static_cast<int>(std::count(cells.begin(), cells.end(), code));
+}
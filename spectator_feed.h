@@ -0,0 +1,176 @@
+/**
+ * @file spectator_feed.h
+ * @brief Classes encoding and decoding the compact stream of board changes watched by spectators.
+ */
+
+#ifndef SPECTATOR_FEED_H
+#define SPECTATOR_FEED_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cell.h"
+
+/**
+ * @brief State of a cell as seen by a spectator, stored in 4 bits.
+ *
+ * Codes 0 to 8 are revealed cells with that number of bombs around.
+ */
+
+enum CellCode : std::uint8_t {
+    code_covered = 9,
+    code_flagged = 10,
+    code_mine = 11
+};
+
+/**
+ * @brief Result of a game sent to the spectators when it ends.
+ */
+
+enum GameResult : std::uint8_t {
+    result_playing,
+    result_lost,
+    result_won,
+    result_quit
+};
+
+/**
+ * @class SpectatorFeed
+ * @brief A class writing the changes of a game to a file, a named pipe or a local socket.
+ *
+ * @details Every message is prefixed with its length. A keyframe (`K`) holds the size of the board and
+ * all cell codes, run-length encoded. A delta (`D`) holds only the runs of changed cells: the gap from
+ * the previous run, the run length and the new codes packed two per byte. A keyframe is sent at the start
+ * of a game, every `keyframe_interval` messages and after a message had to be dropped, so a viewer can
+ * join at any time. A result (`R`) tells how the game ended, as the board alone does not: a cleared
+ * competitive board has its bombs revealed as well. Pipes and sockets are written without blocking: while the reader is behind, new
+ * changes are dropped instead of stalling the game.
+ *
+ * Targets starting with `unix:` are local sockets, anything else is opened as a file or named pipe.
+ */
+
+class SpectatorFeed {
+public:
+    static constexpr int keyframe_interval = 64;
+private:
+    int fd = -1;
+    bool stream = false;
+    bool need_keyframe = true;
+    int width = 0;
+    int height = 0;
+    std::uint32_t frame = 0;
+    std::vector<std::uint8_t> previous;
+    std::vector<std::uint8_t> current;
+    std::vector<std::uint8_t> payload;
+    std::vector<std::uint8_t> backlog;
+    std::vector<std::pair<int, std::uint8_t>> updates;
+    void publish_codes(int new_width, int new_height);
+    void publish_updates();
+    void encode_keyframe();
+    bool encode_delta();
+    bool encode_updates();
+    bool flush_backlog();
+    void send();
+public:
+    SpectatorFeed() = default;
+    ~SpectatorFeed();
+    SpectatorFeed(const SpectatorFeed&) = delete;
+    SpectatorFeed& operator=(const SpectatorFeed&) = delete;
+    bool open(const std::string& target);
+    void close();
+    bool is_open() const;
+    void start_game();
+    void finish_game(GameResult result);
+    template <typename BoardT>
+    void publish(const BoardT& board);
+    template <typename BoardT>
+    void publish(const BoardT& board, const std::vector<int>& changed);
+    static std::uint8_t cell_code(const Cell& cell);
+};
+
+/**
+ * @brief Sends the changes of the board since the previous call.
+ *
+ * @param board Board of the running game.
+ */
+
+template <typename BoardT>
+void SpectatorFeed::publish(const BoardT& board) {
+    if (fd < 0) {
+        return;
+    }
+    const int board_width = board.get_width();
+    const int board_height = board.get_height();
+    current.resize(static_cast<std::size_t>(board_width) * board_height);
+    for (int row = 0; row < board_height; ++row) {
+        for (int column = 0; column < board_width; ++column) {
+            current[static_cast<std::size_t>(row) * board_width + column] = cell_code(board.get_cell(row, column));
+        }
+    }
+    publish_codes(board_width, board_height);
+}
+
+/**
+ * @brief Sends the given changed cells without comparing the whole board.
+ *
+ * Falls back to the full comparison whenever a keyframe is due.
+ *
+ * @param board Board of the running game.
+ * @param changed Indices (`row * width + column`) of the cells changed since the previous call, may repeat.
+ */
+
+template <typename BoardT>
+void SpectatorFeed::publish(const BoardT& board, const std::vector<int>& changed) {
+    if (fd < 0) {
+        return;
+    }
+    const int board_width = board.get_width();
+    if (need_keyframe || board_width != width || board.get_height() != height || frame % keyframe_interval == 0) {
+        publish(board);
+        return;
+    }
+    updates.clear();
+    for (int cell : changed) {
+        updates.emplace_back(cell, cell_code(board.get_cell(cell / board_width, cell % board_width)));
+    }
+    publish_updates();
+}
+
+/**
+ * @class SpectatorDecoder
+ * @brief A class rebuilding the board of a single game from its spectator stream.
+ *
+ * @details Bytes can be fed in chunks of any size, messages are applied once they are complete.
+ * Deltas received before the first keyframe are skipped, as are keyframes of boards larger than
+ * `max_size` in either direction, the largest board of the game.
+ */
+
+class SpectatorDecoder {
+public:
+    static constexpr int max_size = 1000;
+private:
+    std::vector<std::uint8_t> buffer;
+    std::vector<std::uint8_t> cells;
+    int width = 0;
+    int height = 0;
+    std::uint32_t frame = 0;
+    int keyframes = 0;
+    int deltas = 0;
+    GameResult result = result_playing;
+    bool apply(const std::uint8_t* message, std::size_t length);
+public:
+    int feed(const std::uint8_t* data, std::size_t length);
+    int get_width() const;
+    int get_height() const;
+    std::uint32_t get_frame() const;
+    int get_keyframes() const;
+    int get_deltas() const;
+    GameResult get_result() const;
+    std::uint8_t get_code(int row, int column) const;
+    int count(std::uint8_t code) const;
+};
+
+#endif //SPECTATOR_FEED_H
@@ -0,0 +1,476 @@
+/**
+ * @file stats_store.cpp
+ * @brief Implementation of `StatsStore` class and related functionalities.
+ */
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+#include "stats_store.h"
+
+/**
+ * @brief Waits for the pending records and closes the files.
+ */
+
+StatsStore::~StatsStore() {
+    close();
+}
+
+/**
+ * @brief Opens the log and the index of a player, creating them when they do not exist.
+ *
+ * The index is loaded and brought up to date with the records appended after it was saved. A missing
+ * or damaged index is rebuilt from the whole log. An incomplete record and damaged records at the end of
+ * the log are cut off, no valid record is ever removed.
+ *
+ * @param name Path of the files without the extension, `stats_<user>` for example.
+ * @return false if the log cannot be opened for appending.
+ */
+
+bool StatsStore::open(const std::string& name) {
+    close();
+    log_path = name + ".log";
+    index_path = name + ".idx";
+    std::error_code error;
+    const std::uint64_t size = std::filesystem::exists(log_path, error) ? std::filesystem::file_size(log_path, error) : 0;
+    if (!load_index() || covered > size) {
+        std::lock_guard<std::mutex> lock(index_mutex);
+        index.clear();
+        covered = 0;
+    }
+    const std::uint64_t indexed = covered;
+    scan_log(covered, size);
+    if (covered < size) {
+        std::filesystem::resize_file(log_path, covered, error);
+    }
+    log = std::fopen(log_path.c_str(), "ab");
+    if (!log) {
+        return false;
+    }
+    if (covered != indexed) {
+        save_index();
+    }
+    pending = std::make_unique<MessageQueue<Record>>();
+    writer = std::thread(&StatsStore::write_records, this);
+    return true;
+}
+
+/**
+ * @brief Writes the pending records and the index, then closes the log.
+ */
+
+void StatsStore::close() {
+    if (pending) {
+        pending->close();
+    }
+    if (writer.joinable()) {
+        writer.join();
+    }
+    pending.reset();
+    if (log) {
+        std::fclose(log);
+        log = nullptr;
+    }
+}
+
+/**
+ * @brief Checks if games can be recorded.
+ */
+
+bool StatsStore::is_open() const {
+    return log != nullptr;
+}
+
+/**
+ * @brief Queues a finished game for the writer thread, returns at once.
+ *
+ * @param record The game, `checksum` is filled in here.
+ */
+
+void StatsStore::record(Record record) {
+    if (!pending) {
+        return;
+    }
+    record.reserved = 0;
+    record.checksum = checksum(record);
+    pending->push(record);
+}
+
+/**
+ * @brief Gets the best winning times on a board.
+ *
+ * @param key The board.
+ * @param amount Maximal number of times.
+ * @return Times in milliseconds, fastest first.
+ */
+
+std::vector<std::uint32_t> StatsStore::best_times(const Key& key, std::size_t amount) const {
+    std::lock_guard<std::mutex> lock(index_mutex);
+    std::vector<std::uint32_t> times;
+    auto found = index.find(key);
+    if (found != index.end()) {
+        for (std::size_t i = 0; i < std::min(amount, found->second.best.size()); ++i) {
+            times.push_back(found->second.best[i].time_ms);
+        }
+    }
+    return times;
+}
+
+/**
+ * @brief Gets the percentage of won games on a board which took longer than the given time.
+ *
+ * Exact when the time is faster than the slowest of the best games kept, as all games up to it are
+ * among them. Otherwise the histogram is used and the games of one bucket are taken as evenly spread.
+ *
+ * @param key The board.
+ * @param time_ms Time in milliseconds.
+ * @return Percentage from 0 to 100, 0 when no game has been won yet.
+ */
+
+double StatsStore::percentile(const Key& key, std::uint32_t time_ms) const {
+    std::lock_guard<std::mutex> lock(index_mutex);
+    auto found = index.find(key);
+    if (found == index.end() || !found->second.won) {
+        return 0;
+    }
+    const Times& times = found->second;
+    if (times.won == times.best.size() || time_ms < times.best.back().time_ms) {
+        auto slower = std::upper_bound(times.best.begin(), times.best.end(), time_ms,
+                                       [](std::uint32_t time, const Entry& entry) { return time < entry.time_ms; });
+        const std::size_t faster = slower - times.best.begin();
+        return 100.0 * (times.won - faster) / times.won;
+    }
+    const int bucket = bucket_of(time_ms);
+    double slower = 0;
+    for (int i = bucket + 1; i < histogram_size; ++i) {
+        slower += times.histogram[i];
+    }
+    const std::uint64_t end = bucket_start(bucket + 1);
+    slower += static_cast<double>(times.histogram[bucket]) * (end - 1 - time_ms) / (end - bucket_start(bucket));
+    return 100.0 * slower / times.won;
+}
+
+/**
+ * @brief Gets the winning time at the given percentile, 50 gives the median.
+ *
+ * Exact among the best games kept, otherwise interpolated within a bucket of the histogram.
+ *
+ * @param key The board.
+ * @param percentile Percentile from 0 (fastest) to 100 (slowest).
+ * @return Time in milliseconds, 0 when no game has been won yet.
+ */
+
+std::uint32_t StatsStore::time_at(const Key& key, double percentile) const {
+    std::lock_guard<std::mutex> lock(index_mutex);
+    auto found = index.find(key);
+    if (found == index.end() || !found->second.won) {
+        return 0;
+    }
+    const Times& times = found->second;
+    const double clamped = std::min(100.0, std::max(0.0, percentile));
+    const std::uint64_t rank = static_cast<std::uint64_t>(std::llround(clamped / 100 * (times.won - 1)));
+    if (rank < times.best.size()) {
+        return times.best[rank].time_ms;
+    }
+    std::uint64_t before = 0;
+    int bucket = 0;
+    while (before + times.histogram[bucket] <= rank) {
+        before += times.histogram[bucket++];
+    }
+    const std::uint64_t width = bucket_start(bucket + 1) - bucket_start(bucket);
+    return static_cast<std::uint32_t>(bucket_start(bucket) + width * (rank - before) / times.histogram[bucket]);
+}
+
+/**
+ * @brief Gets the number of won games on a board.
+ */
+
+std::size_t StatsStore::won_games(const Key& key) const {
+    std::lock_guard<std::mutex> lock(index_mutex);
+    auto found = index.find(key);
+    return found == index.end() ? 0 : static_cast<std::size_t>(found->second.won);
+}
+
+/**
+ * @brief Gets the number of damaged records skipped while the index was brought up to date.
+ */
+
+std::size_t StatsStore::damaged_records() const {
+    std::lock_guard<std::mutex> lock(index_mutex);
+    return damaged_amount;
+}
+
+/**
+ * @brief Gets the number of records dropped since a write to the log failed.
+ *
+ * Complete only once the store is closed, the writer may still be dropping queued records.
+ */
+
+std::size_t StatsStore::dropped_records() const {
+    std::lock_guard<std::mutex> lock(index_mutex);
+    return dropped_amount;
+}
+
+/**
+ * @brief Computes the CRC-32 of a record without its `checksum` field.
+ */
+
+std::uint32_t StatsStore::checksum(const Record& record) {
+    static const std::array<std::uint32_t, 256> table = [] {
+        std::array<std::uint32_t, 256> values{};
+        for (std::uint32_t i = 0; i < 256; ++i) {
+            std::uint32_t value = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                value = value & 1 ? 0xEDB88320u ^ (value >> 1) : value >> 1;
+            }
+            values[i] = value;
+        }
+        return values;
+    }();
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&record);
+    std::uint32_t crc = 0xFFFFFFFFu;
+    for (std::size_t i = 0; i < offsetof(Record, checksum); ++i) {
+        crc = table[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+/**
+ * @brief Gets the board a record is indexed under.
+ */
+
+StatsStore::Key StatsStore::key_of(const Record& record) {
+    return {record.width, record.height, record.bombs, record.shape, static_cast<std::uint8_t>(record.player != 0)};
+}
+
+/**
+ * @brief Gets the histogram bucket of a time: exact below 16 ms, then 8 buckets for every power of two.
+ */
+
+int StatsStore::bucket_of(std::uint32_t time_ms) {
+    if (time_ms < 16) {
+        return static_cast<int>(time_ms);
+    }
+    int exponent = 4;
+    while (time_ms >> (exponent + 1)) {
+        exponent++;
+    }
+    return (exponent - 2) * 8 + static_cast<int>((time_ms >> (exponent - 3)) & 7);
+}
+
+/**
+ * @brief Gets the fastest time of a histogram bucket, `histogram_size` gives the end of the last one.
+ */
+
+std::uint64_t StatsStore::bucket_start(int bucket) {
+    if (bucket < 16) {
+        return static_cast<std::uint64_t>(bucket);
+    }
+    return static_cast<std::uint64_t>(8 + bucket % 8) << (bucket / 8 - 1);
+}
+
+/**
+ * @brief Adds a won game to the index, other results are only kept in the log.
+ *
+ * The time is counted in the histogram and kept among the best games if it is fast enough,
+ * so adding a game never costs more than shifting `best_amount` entries.
+ * Must be called with `index_mutex` locked.
+ *
+ * @param record The game.
+ * @param number Position of the record in the log.
+ */
+
+void StatsStore::add_to_index(const Record& record, std::uint32_t number) {
+    if (record.result != won) {
+        return;
+    }
+    Times& times = index[key_of(record)];
+    times.histogram[bucket_of(record.time_ms)]++;
+    times.won++;
+    if (times.best.size() == best_amount && record.time_ms >= times.best.back().time_ms) {
+        return;
+    }
+    auto position = std::upper_bound(times.best.begin(), times.best.end(), record.time_ms,
+                                     [](std::uint32_t time, const Entry& entry) { return time < entry.time_ms; });
+    times.best.insert(position, {record.time_ms, number});
+    if (times.best.size() > best_amount) {
+        times.best.pop_back();
+    }
+}
+
+/**
+ * @brief Reads the records appended after `from` and adds them to the index.
+ *
+ * Records failing their checksum are skipped. When valid records follow them they are counted as
+ * damaged and stay in the log, otherwise they were torn by a crash. `covered` ends after the last
+ * valid record, so the torn records and an incomplete last record are cut off by `open`.
+ *
+ * @param from Offset of the first record to read.
+ * @param size Length of the log.
+ */
+
+void StatsStore::scan_log(std::uint64_t from, std::uint64_t size) {
+    std::ifstream file(log_path, std::ios::binary);
+    file.seekg(static_cast<std::streamoff>(from));
+    std::lock_guard<std::mutex> lock(index_mutex);
+    covered = from;
+    std::uint64_t position = from;
+    std::size_t skipped = 0;
+    Record record;
+    while (position + sizeof(Record) <= size && file.read(reinterpret_cast<char*>(&record), sizeof(record))) {
+        position += sizeof(Record);
+        if (record.checksum != checksum(record)) {
+            skipped++;
+            continue;
+        }
+        add_to_index(record, static_cast<std::uint32_t>(position / sizeof(Record) - 1));
+        covered = position;
+        damaged_amount += skipped;
+        skipped = 0;
+    }
+    record_amount = covered / sizeof(Record);
+}
+
+/**
+ * @brief Loads the saved index.
+ *
+ * @return false if the index does not exist or is not valid.
+ */
+
+bool StatsStore::load_index() {
+    std::ifstream file(index_path, std::ios::binary);
+    std::vector<char> contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    IndexHeader header;
+    if (contents.size() < sizeof(header)) {
+        return false;
+    }
+    std::memcpy(&header, contents.data(), sizeof(header));
+    if (std::memcmp(header.magic, "MSST", 4) != 0 || header.version != version || header.covered % sizeof(Record)
+        || contents.size() < sizeof(header) + static_cast<std::size_t>(header.key_amount) * sizeof(IndexBucket)) {
+        return false;
+    }
+    std::map<Key, Times> loaded;
+    for (std::uint32_t i = 0; i < header.key_amount; ++i) {
+        IndexBucket bucket;
+        std::memcpy(&bucket, contents.data() + sizeof(header) + i * sizeof(IndexBucket), sizeof(bucket));
+        const std::uint64_t best_size = static_cast<std::uint64_t>(bucket.amount) * sizeof(Entry);
+        if (bucket.amount > best_amount || bucket.offset > contents.size()
+            || best_size + sizeof(Times::histogram) > contents.size() - bucket.offset) {
+            return false;
+        }
+        Times& times = loaded[bucket.key];
+        times.best.resize(bucket.amount);
+        std::memcpy(times.best.data(), contents.data() + bucket.offset, best_size);
+        std::memcpy(times.histogram.data(), contents.data() + bucket.offset + best_size, sizeof(times.histogram));
+        for (std::uint32_t count : times.histogram) {
+            times.won += count;
+        }
+        if (times.won < times.best.size()) {
+            return false;
+        }
+    }
+    std::lock_guard<std::mutex> lock(index_mutex);
+    index.swap(loaded);
+    covered = header.covered;
+    return true;
+}
+
+/**
+ * @brief Saves the index next to the log.
+ *
+ * The index is written to a temporary file which then replaces the old one, so a crash leaves
+ * either the old or the new index. Either way it is brought up to date from the log on open.
+ *
+ * @return false if the index could not be written.
+ */
+
+bool StatsStore::save_index() {
+    std::vector<char> contents;
+    {
+        std::lock_guard<std::mutex> lock(index_mutex);
+        IndexHeader header{{'M', 'S', 'S', 'T'}, version, covered, static_cast<std::uint32_t>(index.size()), 0};
+        std::uint64_t offset = sizeof(header) + index.size() * sizeof(IndexBucket);
+        contents.resize(offset);
+        std::memcpy(contents.data(), &header, sizeof(header));
+        std::size_t position = sizeof(header);
+        for (const auto& [key, times] : index) {
+            IndexBucket bucket{key, static_cast<std::uint32_t>(times.best.size()), 0, offset};
+            std::memcpy(contents.data() + position, &bucket, sizeof(bucket));
+            position += sizeof(bucket);
+            const char* bytes = reinterpret_cast<const char*>(times.best.data());
+            contents.insert(contents.end(), bytes, bytes + times.best.size() * sizeof(Entry));
+            bytes = reinterpret_cast<const char*>(times.histogram.data());
+            contents.insert(contents.end(), bytes, bytes + sizeof(times.histogram));
+            offset += times.best.size() * sizeof(Entry) + sizeof(times.histogram);
+        }
+    }
+    const std::string temporary = index_path + ".tmp";
+    std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+    file.write(contents.data(), contents.size());
+    file.close();
+    if (!file) {
+        std::remove(temporary.c_str());
+        return false;
+    }
+#ifdef _WIN32
+    std::remove(index_path.c_str());
+#endif
+    return std::rename(temporary.c_str(), index_path.c_str()) == 0;
+}
+
+/**
+ * @brief Writer thread, appends the queued records until the store is closed.
+ *
+ * All records queued at the moment are appended together and synced to the disk before they
+ * are indexed. The index is saved after every `index_interval` records and once more when the
+ * store is closed. Once a write or sync fails the queue is still drained, so it does not grow,
+ * but the records are dropped and counted instead of being appended after a possibly torn one.
+ */
+
+void StatsStore::write_records() {
+    std::vector<Record> records(1);
+    int unsaved = 0;
+    bool failed = false;
+    while (pending->pop(records.front())) {
+        Record record;
+        while (pending->try_pop(record)) {
+            records.push_back(record);
+        }
+        failed = failed || std::fwrite(records.data(), sizeof(Record), records.size(), log) != records.size() ||
+                 std::fflush(log) != 0;
+#ifndef _WIN32
+        failed = failed || fdatasync(fileno(log)) != 0;
+#endif
+        if (failed) {
+            std::lock_guard<std::mutex> lock(index_mutex);
+            dropped_amount += records.size();
+            records.resize(1);
+            continue;
+        }
+        {
+            std::lock_guard<std::mutex> lock(index_mutex);
+            for (const Record& written : records) {
+                add_to_index(written, static_cast<std::uint32_t>(record_amount++));
+            }
+            covered += records.size() * sizeof(Record);
+        }
+        unsaved += static_cast<int>(records.size());
+        records.resize(1);
+        if (unsaved >= index_interval) {
+            save_index();
+            unsaved = 0;
+        }
+    }
+    if (unsaved) {
+        save_index();
+    }
+}
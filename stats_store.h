@@ -0,0 +1,155 @@
+/**
+ * @file stats_store.h
+ * @brief Class keeping the results of all played games in an append-only file.
+ */
+
+#ifndef STATS_STORE_H
+#define STATS_STORE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "message_queue.h"
+
+/**
+ * @class StatsStore
+ * @brief A persistent log of finished games with a sorted index of winning times.
+ *
+ * @details Games are appended to the log (`<name>.log`) as fixed size `Record`s protected by a checksum.
+ * Appending and syncing happens on a writer thread, so `record` never waits for the disk. Records torn
+ * by a crash at the end of the log are cut off the next time the store is opened, damaged records
+ * followed by valid ones are skipped and counted but stay in the log. After a failed write the log may
+ * end with part of a record, so the writer stops appending and drops the following records, counting them.
+ *
+ * Won games are summarised by board (`Key`: size, bombs, shape, human or bot) in `Times`: the `best_amount`
+ * fastest games and a histogram of all times, so the index has the same size after millions of games and
+ * best times and percentiles are answered from it alone. The index is saved to `<name>.idx` (written to
+ * a temporary file and renamed) together with the length of the log it covers; on open only the records
+ * appended after that are read.
+ */
+
+class StatsStore {
+public:
+    static constexpr const char* default_name = "stats";
+    static constexpr std::uint32_t version = 2;
+    static constexpr int index_interval = 256;
+    static constexpr std::size_t best_amount = 100;
+    static constexpr int histogram_size = 240;
+
+    enum Result : std::uint8_t {
+        lost = 0,
+        won = 1,
+        quit = 2
+    };
+
+    struct Record {
+        std::uint16_t width;
+        std::uint16_t height;
+        std::uint16_t bombs;
+        std::uint8_t shape;
+        std::uint8_t result;
+        std::uint32_t player;
+        std::uint32_t time_ms;
+        std::uint32_t bbbv;
+        std::uint32_t moves;
+        std::int64_t finished_at;
+        std::uint32_t reserved;
+        std::uint32_t checksum;
+    };
+
+    /**
+     * @brief Board the times are compared on, human and bot games are kept apart.
+     */
+    struct Key {
+        std::uint16_t width;
+        std::uint16_t height;
+        std::uint16_t bombs;
+        std::uint8_t shape;
+        std::uint8_t bot;
+        bool operator<(const Key& other) const {
+            return std::tie(width, height, bombs, shape, bot)
+                   < std::tie(other.width, other.height, other.bombs, other.shape, other.bot);
+        }
+    };
+
+    struct IndexHeader {
+        char magic[4];
+        std::uint32_t version;
+        std::uint64_t covered;
+        std::uint32_t key_amount;
+        std::uint32_t reserved;
+    };
+
+    struct IndexBucket {
+        Key key;
+        std::uint32_t amount;
+        std::uint32_t reserved;
+        std::uint64_t offset;
+    };
+
+    /**
+     * @brief Winning time together with the number of its record in the log.
+     */
+    struct Entry {
+        std::uint32_t time_ms;
+        std::uint32_t record;
+    };
+
+    /**
+     * @brief Won games on one board: the fastest ones sorted by time and a histogram of all times.
+     *
+     * The histogram has 8 buckets for every power of two, so a bucket is at most 1/8 of its times wide.
+     */
+    struct Times {
+        std::vector<Entry> best;
+        std::array<std::uint32_t, histogram_size> histogram{};
+        std::uint64_t won = 0;
+    };
+private:
+    std::string log_path;
+    std::string index_path;
+    std::FILE* log = nullptr;
+    std::uint64_t covered = 0;
+    std::uint64_t record_amount = 0;
+    std::size_t damaged_amount = 0;
+    std::size_t dropped_amount = 0;
+    std::map<Key, Times> index;
+    mutable std::mutex index_mutex;
+    std::unique_ptr<MessageQueue<Record>> pending;
+    std::thread writer;
+    bool load_index();
+    bool save_index();
+    void scan_log(std::uint64_t from, std::uint64_t size);
+    void add_to_index(const Record& record, std::uint32_t number);
+    void write_records();
+    static Key key_of(const Record& record);
+    static int bucket_of(std::uint32_t time_ms);
+    static std::uint64_t bucket_start(int bucket);
+public:
+    StatsStore() = default;
+    ~StatsStore();
+    StatsStore(const StatsStore&) = delete;
+    StatsStore& operator=(const StatsStore&) = delete;
+    bool open(const std::string& name);
+    void close();
+    bool is_open() const;
+    void record(Record record);
+    std::vector<std::uint32_t> best_times(const Key& key, std::size_t amount) const;
+    double percentile(const Key& key, std::uint32_t time_ms) const;
+    std::uint32_t time_at(const Key& key, double percentile) const;
+    std::size_t won_games(const Key& key) const;
+    std::size_t damaged_records() const;
+    std::size_t dropped_records() const;
+    static std::uint32_t checksum(const Record& record);
+};
+
+#endif //STATS_STORE_H
@@ -0,0 +1,39 @@
+/**
+ * @file summed_area_table.cpp
+ * @brief Implementation of `SummedAreaTable` class.
+ */
+
+#include <algorithm>
+
+#include "summed_area_table.h"
+
+/**
+ * @brief Counts the set cells of a rectangle, the parts outside of the grid are ignored.
+ *
+ * @param top First row of the rectangle.
+ * @param left First column of the rectangle.
+ * @param bottom Last row of the rectangle.
+ * @param right Last column of the rectangle.
+ * @return Number of set cells, 0 for an empty rectangle.
+ */
+
+int SummedAreaTable::count(int top, int left, int bottom, int right) const {
+    top = std::max(top, 0);
+    left = std::max(left, 0);
+    bottom = std::min(bottom, height - 1);
+    right = std::min(right, width - 1);
+    if (top > bottom || left > right) {
+        return 0;
+    }
+    const int stride = width + 1;
+    return sums[(bottom + 1) * stride + right + 1] - sums[top * stride + right + 1]
+           - sums[(bottom + 1) * stride + left] + sums[top * stride + left];
+}
+
+/**
+ * @brief Counts the set cells of the whole grid.
+ */
+
+int SummedAreaTable::total() const {
+    return sums.empty() ? 0 : sums.back();
+}
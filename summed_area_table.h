@@ -0,0 +1,54 @@
+/**
+ * @file summed_area_table.h
+ * @brief Class counting set cells in rectangles of a grid which does not change during the game.
+ */
+
+#ifndef SUMMED_AREA_TABLE_H
+#define SUMMED_AREA_TABLE_H
+
+#include <vector>
+
+/**
+ * @class SummedAreaTable
+ * @brief Prefix sums of a grid, every cell holds the number of set cells above and left of it.
+ *
+ * @details Counting a rectangle takes four lookups. Changing a cell needs the table to be built
+ * again, so it is used for planes fixed once the game starts, like the bombs.
+ */
+
+class SummedAreaTable {
+private:
+    int width = 0;
+    int height = 0;
+    std::vector<int> sums;
+public:
+    template <typename Predicate>
+    void build(int w, int h, Predicate is_set);
+    int count(int top, int left, int bottom, int right) const;
+    int total() const;
+};
+
+/**
+ * @brief Fills the table from a predicate in O(width * height).
+ *
+ * @param w Width of the grid.
+ * @param h Height of the grid.
+ * @param is_set Called with the row and the column, true if the cell is counted.
+ */
+
+template <typename Predicate>
+void SummedAreaTable::build(int w, int h, Predicate is_set) {
+    width = w;
+    height = h;
+    const int stride = width + 1;
+    sums.assign(static_cast<std::size_t>(height + 1) * stride, 0);
+    for (int row = 1; row <= height; ++row) {
+        int row_sum = 0;
+        for (int column = 1; column <= width; ++column) {
+            row_sum += is_set(row - 1, column - 1) ? 1 : 0;
+            sums[row * stride + column] = sums[(row - 1) * stride + column] + row_sum;
+        }
+    }
+}
+
+#endif //SUMMED_AREA_TABLE_H
@@ -0,0 +1,137 @@
+/**
+ * @file board_bench.cpp
+ * @brief Benchmark comparing the compile-time `FixedBoard` presets with the dynamic `Board`.
+ *
+ * @details Usage: `board_bench [games per preset]`, 20000 by default. Both boards play the same
+ * games: the bombs are placed from the same bitmaps, then every safe cell is revealed in the same
+ * random order (which exercises the flood fill) and every bomb is flagged. A checksum of the final
+ * boards makes sure both did the same work. A single 1000x1000 `Board` flood reveal is timed as well.
+ * Build it with:
+ * `g++ -std=c++17 -O2 -I.. board_bench.cpp ../board.cpp ../cell.cpp ../randomizer.cpp ../topology.cpp
+ * ../fenwick_tree.cpp ../summed_area_table.cpp`
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "board.h"
+#include "fixed_board.h"
+
+/**
+ * @brief A prepared game, the same for both board types.
+ */
+
+struct Game {
+    std::vector<std::uint8_t> mines;
+    std::vector<int> order;
+};
+
+/**
+ * @brief Prepares random games of one preset.
+ *
+ * @param width Width of the board.
+ * @param height Height of the board.
+ * @param bombs Number of bombs.
+ * @param amount Number of games.
+ * @return Mine bitmaps with a random order of the cells to reveal.
+ */
+
+std::vector<Game> prepare(int width, int height, int bombs, int amount) {
+    std::mt19937 random(42);
+    std::vector<Game> games(amount);
+    for (Game& game : games) {
+        game.mines.assign((width * height + 7) / 8, 0);
+        for (int placed = 0; placed < bombs;) {
+            const int cell = static_cast<int>(random() % (width * height));
+            if (!((game.mines[cell >> 3] >> (cell & 7)) & 1)) {
+                game.mines[cell >> 3] |= 1 << (cell & 7);
+                placed++;
+            }
+        }
+        for (int cell = 0; cell < width * height; ++cell) {
+            game.order.push_back(cell);
+        }
+        std::shuffle(game.order.begin(), game.order.end(), random);
+    }
+    return games;
+}
+
+/**
+ * @brief Plays all games on one board type.
+ *
+ * @param games Prepared games.
+ * @param checksum Increased by the state of every finished board.
+ * @return Average time of a game in microseconds.
+ */
+
+template <typename BoardT>
+double play(const std::vector<Game>& games, int width, int height, std::uint64_t& checksum) {
+    const auto start = std::chrono::steady_clock::now();
+    for (const Game& game : games) {
+        BoardT board(width, height, 0, 0, 0);
+        board.place_bombs_from(game.mines.data());
+        for (int row = 0; row < height; ++row) {
+            for (int column = 0; column < width; ++column) {
+                board.count_bombs(row, column);
+            }
+        }
+        for (int cell : game.order) {
+            const int row = cell / width;
+            const int column = cell % width;
+            Cell& target = board.get_cell(row, column);
+            if (target.get_is_bomb()) {
+                board.handle_second_mode(target);
+            } else {
+                board.handle_first_mode(board, target, row, column);
+            }
+        }
+        checksum += board.handle_win_condition() + board.get_changed().size();
+    }
+    const std::chrono::duration<double, std::micro> time = std::chrono::steady_clock::now() - start;
+    return time.count() / games.size();
+}
+
+/**
+ * @brief Runs one preset on both board types and prints the times.
+ */
+
+template <int W, int H>
+void compare(int bombs, int amount) {
+    const std::vector<Game> games = prepare(W, H, bombs, amount);
+    std::uint64_t fixed_checksum = 0;
+    std::uint64_t dynamic_checksum = 0;
+    const double fixed = play<FixedBoard<W, H>>(games, W, H, fixed_checksum);
+    const double dynamic = play<Board>(games, W, H, dynamic_checksum);
+    std::cout << std::fixed << std::setprecision(2) << W << "x" << H << ": FixedBoard " << fixed
+              << " us, Board " << dynamic << " us per game, speed-up " << dynamic / fixed
+              << (fixed_checksum == dynamic_checksum ? "" : " (checksums differ!)") << std::endl;
+}
+
+/**
+ * @brief Times the presets and the flood reveal of a large board.
+ */
+
+int main(int argc, char* argv[]) {
+    const int amount = argc > 1 ? std::max(1, std::atoi(argv[1])) : 20000;
+    compare<9, 9>(10, amount);
+    compare<16, 16>(40, amount);
+    compare<30, 16>(99, amount);
+    const int side = 1000;
+    Board board(side, side, 0, 0, 0);
+    for (int row = 0; row < side; ++row) {
+        for (int column = 0; column < side; ++column) {
+            board.count_bombs(row, column);
+        }
+    }
+    const auto start = std::chrono::steady_clock::now();
+    board.handle_first_mode(board, board.get_cell(0, 0), 0, 0);
+    const std::chrono::duration<double, std::milli> time = std::chrono::steady_clock::now() - start;
+    std::cout << side << "x" << side << " flood reveal: " << time.count() << " ms" << std::endl;
+    return 0;
+}
@@ -0,0 +1,83 @@
+/**
+ * @file generate_puzzle_bank.cpp
+ * @brief Offline tool filling the puzzle bank used by the game for instant starts.
+ *
+ * @details Usage: `generate_puzzle_bank [output] [boards per preset]`, by default
+ * `puzzles.bank` with 1000 boards for each of the standard presets. Build it with:
+ * `g++ -std=c++17 -O2 -I.. generate_puzzle_bank.cpp ../puzzle_bank.cpp ../randomizer.cpp`
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "puzzle_bank.h"
+#include "randomizer.h"
+
+/**
+ * @brief Generates a single board the same way as `Board::place_bombs`.
+ *
+ * A random first click is chosen and no bomb is placed on or around it.
+ *
+ * @param rng Random number generator.
+ * @param width Width of the board.
+ * @param height Height of the board.
+ * @param bombs Number of bombs to place.
+ * @return Generated board with its 3BV, difficulty is filled in later.
+ */
+
+PuzzleBank::GeneratedPuzzle generate(RandomNumberGenerator& rng, int width, int height, int bombs) {
+    PuzzleBank::GeneratedPuzzle puzzle{width, height, bombs, 0, 0, 0, 0, {}};
+    puzzle.mines.assign((width * height + 7) / 8, 0);
+    puzzle.first_x = rng.get_random_number(0, height - 1);
+    puzzle.first_y = rng.get_random_number(0, width - 1);
+    int changed = 0;
+    while (changed < bombs) {
+        int row = rng.get_random_number(0, height - 1);
+        int column = rng.get_random_number(0, width - 1);
+        int index = row * width + column;
+        if (std::abs(row - puzzle.first_x) <= 1 && std::abs(column - puzzle.first_y) <= 1) {
+            continue;
+        }
+        if (!((puzzle.mines[index >> 3] >> (index & 7)) & 1)) {
+            puzzle.mines[index >> 3] |= 1 << (index & 7);
+            changed++;
+        }
+    }
+    puzzle.bbbv = PuzzleBank::count_3bv(width, height, puzzle.mines.data());
+    return puzzle;
+}
+
+/**
+ * @brief Generates the boards of the standard presets and writes the bank.
+ *
+ * Boards of every preset are split into three difficulties (0 - easy, 1 - medium, 2 - hard)
+ * by their 3BV.
+ */
+
+int main(int argc, char* argv[]) {
+    const std::string path = argc > 1 ? argv[1] : PuzzleBank::default_path;
+    const int amount = argc > 2 ? std::max(1, std::atoi(argv[2])) : 1000;
+    const int presets[][3] = {{9, 9, 10}, {16, 16, 40}, {30, 16, 99}};
+    RandomNumberGenerator rng;
+    std::vector<PuzzleBank::GeneratedPuzzle> puzzles;
+    for (const auto& preset : presets) {
+        std::vector<PuzzleBank::GeneratedPuzzle> boards;
+        for (int i = 0; i < amount; ++i) {
+            boards.push_back(generate(rng, preset[0], preset[1], preset[2]));
+        }
+        std::sort(boards.begin(), boards.end(), [](const auto& a, const auto& b) { return a.bbbv < b.bbbv; });
+        for (int i = 0; i < amount; ++i) {
+            boards[i].difficulty = i * 3 / amount;
+            puzzles.push_back(std::move(boards[i]));
+        }
+    }
+    if (!PuzzleBank::write(path, puzzles)) {
+        std::cerr << "Could not write " << path << std::endl;
+        return 1;
+    }
+    std::cout << "Written " << puzzles.size() << " boards to " << path << std::endl;
+    return 0;
+}
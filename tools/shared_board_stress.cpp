@@ -0,0 +1,106 @@
+/**
+ * @file shared_board_stress.cpp
+ * @brief Stress test of the lock-free `SharedBoard` with many threads on one large board.
+ *
+ * @details Usage: `shared_board_stress [threads] [size]`, 15 threads on a 1000x1000 board by default.
+ * Every bomb is flagged first, then the cells are shuffled and dealt to the threads in turn. Each thread
+ * chords its revealed cells and reveals its covered ones, so cascades and chords of different threads run
+ * into each other all the time. Boards of the same size are cleared with 1, 2, 4, ... threads. Afterwards every thread
+ * must have been credited exactly the cells its calls returned, no bomb may be revealed and the scores must
+ * add up to the number of revealed safe cells. As every revealed cell is credited at least once, the last
+ * check means that no cell has been credited twice.
+ * Build it with:
+ * `g++ -std=c++17 -O2 -pthread -I.. shared_board_stress.cpp ../shared_board.cpp ../cell.cpp ../randomizer.cpp`
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "shared_board.h"
+
+/**
+ * @brief Clears a new board with the given number of threads and checks its consistency.
+ *
+ * @param threads Number of threads, each playing as its own player.
+ * @param size Width and height of the board.
+ * @return true if the board stayed consistent.
+ */
+
+bool stress(int threads, int size) {
+    const int bombs = size * size / 5;
+    SharedBoard board(size, size, bombs);
+    board.place_bombs(size / 2, size / 2);
+    board.count_bombs();
+    std::vector<char> is_bomb(size * size);
+    for (int row = 0; row < size; ++row) {
+        for (int column = 0; column < size; ++column) {
+            is_bomb[row * size + column] = board.get_cell(row, column).get_is_bomb();
+            if (is_bomb[row * size + column]) {
+                board.toggle_flag(row, column);
+            }
+        }
+    }
+    std::vector<int> order(size * size);
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), std::mt19937(size));
+    std::vector<long long> returned(threads, 0);
+    std::vector<char> hit(threads, false);
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (int player = 0; player < threads; ++player) {
+        workers.emplace_back([&, player] {
+            for (std::size_t i = player; i < order.size(); i += threads) {
+                const int index = order[i];
+                const int row = index / size;
+                const int column = index % size;
+                if (is_bomb[index]) {
+                    continue;
+                }
+                const int cells = board.is_revealed(row, column) ? board.chord(row, column, player)
+                                                                 : board.reveal(row, column, player);
+                if (cells < 0) {
+                    hit[player] = true;
+                    return;
+                }
+                returned[player] += cells;
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    const std::chrono::duration<double, std::milli> time = std::chrono::steady_clock::now() - start;
+    bool consistent = board.is_cleared();
+    long long scores = 0;
+    for (int player = 0; player < threads; ++player) {
+        scores += board.get_score(player);
+        consistent = consistent && !hit[player] && returned[player] == board.get_score(player);
+    }
+    long long revealed = 0;
+    for (int index = 0; index < size * size; ++index) {
+        const bool cell_revealed = board.is_revealed(index / size, index % size);
+        consistent = consistent && !(cell_revealed && is_bomb[index]);
+        revealed += cell_revealed;
+    }
+    consistent = consistent && scores == revealed && revealed == size * size - bombs;
+    std::cout << threads << " threads: " << time.count() << " ms, " << revealed << " cells revealed, "
+              << scores << " credited" << (consistent ? "" : " - INCONSISTENT") << std::endl;
+    return consistent;
+}
+
+int main(int argc, char* argv[]) {
+    const int threads = argc > 1 ? std::clamp(std::atoi(argv[1]), 1, SharedBoard::max_players) : 15;
+    const int size = argc > 2 ? std::clamp(std::atoi(argv[2]), 5, SharedBoard::max_size) : 1000;
+    bool consistent = true;
+    for (int amount = 1; amount < threads; amount *= 2) {
+        consistent = stress(amount, size) && consistent;
+    }
+    consistent = stress(threads, size) && consistent;
+    return consistent ? 0 : 1;
+}
@@ -0,0 +1,218 @@
+/**
+ * @file spectator_viewer.cpp
+ * @brief Lightweight viewer following many spectator streams of running games at once.
+ *
+ * @details Usage: `spectator_viewer [--listen <socket>] [--show <index>] [stream ...]`.
+ * Streams are files or named pipes written by games started with `--spectate <path>`. With `--listen`
+ * the viewer also accepts games started with `--spectate unix:<socket>`. Every stream is decoded by its
+ * own `SpectatorDecoder` in a single thread; a summary of all games is printed a few times per second
+ * and the board of the game selected with `--show` is drawn below it. Build it with:
+ * `g++ -std=c++17 -O2 -I.. spectator_viewer.cpp ../spectator_feed.cpp ../cell.cpp`
+ */
+
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "spectator_feed.h"
+
+/**
+ * @brief A followed game.
+ */
+
+struct Source {
+    std::string name;
+    int fd;
+    bool socket;
+    bool open;
+    SpectatorDecoder decoder;
+};
+
+/**
+ * @brief Reads everything which is available from a source without blocking.
+ *
+ * Files and pipes stay open at their end, so they can be followed while the game writes.
+ */
+
+void read_available(Source& source) {
+    std::uint8_t chunk[65536];
+    while (source.open) {
+        ssize_t count = read(source.fd, chunk, sizeof(chunk));
+        if (count > 0) {
+            source.decoder.feed(chunk, count);
+            continue;
+        }
+        if (count == 0 && source.socket) {
+            close(source.fd);
+            source.open = false;
+        }
+        if (count < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+            close(source.fd);
+            source.open = false;
+        }
+        break;
+    }
+}
+
+/**
+ * @brief Opens the local socket the games connect to.
+ */
+
+int listen_on(const std::string& path) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+    unlink(path.c_str());
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(fd, 128) != 0) {
+        std::cerr << "Could not listen on " << path << std::endl;
+        std::exit(1);
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    return fd;
+}
+
+/**
+ * @brief Draws the decoded board of a game.
+ */
+
+void print_board(const SpectatorDecoder& decoder) {
+    for (int row = 0; row < decoder.get_height(); ++row) {
+        for (int column = 0; column < decoder.get_width(); ++column) {
+            std::uint8_t code = decoder.get_code(row, column);
+            if (code == code_covered) {
+                std::cout << "■";
+            } else if (code == code_flagged) {
+                std::cout << "⚐";
+            } else if (code == code_mine) {
+                std::cout << "⚹";
+            } else if (code) {
+                std::cout << static_cast<int>(code);
+            } else {
+                std::cout << " ";
+            }
+        }
+        std::cout << '\n';
+    }
+}
+
+/**
+ * @brief Describes the state of a followed game.
+ */
+
+const char* game_state(const Source& source) {
+    switch (source.decoder.get_result()) {
+        case result_lost:
+            return "lost";
+        case result_won:
+            return "won";
+        case result_quit:
+            return "quit";
+        default:
+            return source.open ? "live" : "closed";
+    }
+}
+
+/**
+ * @brief Prints the summary of all followed games.
+ */
+
+void print_summary(const std::vector<std::unique_ptr<Source>>& sources, int shown) {
+    std::cout << "\033[H\033[2J";
+    std::cout << "  #  stream                    size        frame  keyframes   deltas  revealed  flags  state\n";
+    for (size_t i = 0; i < sources.size(); ++i) {
+        const SpectatorDecoder& decoder = sources[i]->decoder;
+        int cells = decoder.get_width() * decoder.get_height();
+        int covered = decoder.count(code_covered);
+        int flags = decoder.count(code_flagged);
+        int mines = decoder.count(code_mine);
+        int revealed = cells - covered - flags - mines;
+        std::string size = std::to_string(decoder.get_width()) + "x" + std::to_string(decoder.get_height());
+        std::cout << std::setw(3) << i << "  " << std::left << std::setw(24) << sources[i]->name.substr(0, 24)
+                  << "  " << std::setw(10) << size << std::right
+                  << std::setw(7) << decoder.get_frame() << std::setw(11) << decoder.get_keyframes()
+                  << std::setw(9) << decoder.get_deltas()
+                  << std::setw(9) << (cells ? revealed * 100 / cells : 0) << "%" << std::setw(7) << flags
+                  << "  " << game_state(*sources[i]) << '\n';
+    }
+    if (shown >= 0 && shown < static_cast<int>(sources.size())) {
+        std::cout << '\n';
+        print_board(sources[shown]->decoder);
+    }
+    std::cout << std::flush;
+}
+
+/**
+ * @brief Follows the given streams like `tail -f`, exits when only closed sockets are left.
+ */
+
+int main(int argc, char* argv[]) {
+    std::vector<std::unique_ptr<Source>> sources;
+    int listener = -1;
+    int shown = -1;
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+        if (argument == "--listen" && i + 1 < argc) {
+            listener = listen_on(argv[++i]);
+        } else if (argument == "--show" && i + 1 < argc) {
+            shown = std::atoi(argv[++i]);
+        } else {
+            int fd = open(argument.c_str(), O_RDONLY | O_NONBLOCK);
+            if (fd < 0) {
+                std::cerr << "Could not open " << argument << std::endl;
+                return 1;
+            }
+            sources.push_back(std::unique_ptr<Source>(new Source{argument, fd, false, true, {}}));
+        }
+    }
+    if (sources.empty() && listener < 0) {
+        std::cerr << "Usage: spectator_viewer [--listen <socket>] [--show <index>] [stream ...]" << std::endl;
+        return 1;
+    }
+    auto last_draw = std::chrono::steady_clock::now();
+    while (true) {
+        std::vector<pollfd> watched;
+        if (listener >= 0) {
+            watched.push_back({listener, POLLIN, 0});
+        }
+        for (const auto& source : sources) {
+            if (source->open && source->socket) {
+                watched.push_back({source->fd, POLLIN, 0});
+            }
+        }
+        poll(watched.data(), watched.size(), 100);
+        if (listener >= 0) {
+            int client;
+            while ((client = accept(listener, nullptr, nullptr)) >= 0) {
+                fcntl(client, F_SETFL, fcntl(client, F_GETFL) | O_NONBLOCK);
+                std::string name = "socket " + std::to_string(sources.size());
+                sources.push_back(std::unique_ptr<Source>(new Source{name, client, true, true, {}}));
+            }
+        }
+        bool any_open = listener >= 0;
+        for (auto& source : sources) {
+            read_available(*source);
+            any_open = any_open || source->open;
+        }
+        auto now = std::chrono::steady_clock::now();
+        if (now - last_draw > std::chrono::milliseconds(250) || !any_open) {
+            print_summary(sources, shown);
+            last_draw = now;
+        }
+        if (!any_open) {
+            return 0;
+        }
+    }
+}
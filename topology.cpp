@@ -0,0 +1,118 @@
+/**
+ * @file topology.cpp
+ * @brief Implementation of `Topology` class.
+ */
+
+#include <algorithm>
+
+#include "topology.h"
+
+/**
+ * @brief Builds the adjacency table of a board.
+ *
+ * The neighbours of every cell are found once, turned into offsets from the cell and shared
+ * with all cells having the same offsets. A board has at most 9 patterns (18 when hexagonal):
+ * the inner cells, the edges and the corners.
+ *
+ * @param w Width of the board.
+ * @param h Height of the board.
+ * @param s Shape of the board.
+ */
+
+Topology::Topology(int w, int h, Shape s) : width(w), height(h), shape(s) {
+    patterns.reserve(static_cast<std::size_t>(width) * height);
+    offsets.push_back(0);
+    std::vector<int> around;
+    for (int row = 0; row < height; ++row) {
+        for (int column = 0; column < width; ++column) {
+            const int cell = row * width + column;
+            around.clear();
+            if (shape == Shape::Hexagon) {
+                const int shift = row % 2;
+                add_neighbour(around, cell, row - 1, column - 1 + shift);
+                add_neighbour(around, cell, row - 1, column + shift);
+                add_neighbour(around, cell, row, column - 1);
+                add_neighbour(around, cell, row, column + 1);
+                add_neighbour(around, cell, row + 1, column - 1 + shift);
+                add_neighbour(around, cell, row + 1, column + shift);
+            } else {
+                for (int i = row - 1; i <= row + 1; ++i) {
+                    for (int j = column - 1; j <= column + 1; ++j) {
+                        add_neighbour(around, cell, i, j);
+                    }
+                }
+            }
+            patterns.push_back(add_pattern(around));
+        }
+    }
+}
+
+/**
+ * @brief Appends the offset of a neighbour of the cell being built.
+ *
+ * Positions outside of the board are skipped, or wrapped around on a torus. The cell itself
+ * and repeated cells (a torus narrower than 3 cells) are skipped as well.
+ *
+ * @param around Offsets of the neighbours found so far.
+ * @param cell Index of the cell being built.
+ * @param row Row of the neighbour.
+ * @param column Column of the neighbour.
+ */
+
+void Topology::add_neighbour(std::vector<int>& around, int cell, int row, int column) const {
+    if (shape == Shape::Torus) {
+        row = (row + height) % height;
+        column = (column + width) % width;
+    } else if (row < 0 || row >= height || column < 0 || column >= width) {
+        return;
+    }
+    const int delta = row * width + column - cell;
+    if (delta != 0 && std::find(around.begin(), around.end(), delta) == around.end()) {
+        around.push_back(delta);
+    }
+}
+
+/**
+ * @brief Finds the pattern with the given offsets, adds it when it is new.
+ *
+ * @param around Offsets of the neighbours of a cell.
+ * @return Number of the pattern.
+ */
+
+std::uint8_t Topology::add_pattern(const std::vector<int>& around) {
+    const int pattern_amount = static_cast<int>(offsets.size()) - 1;
+    for (int pattern = 0; pattern < pattern_amount; ++pattern) {
+        if (std::equal(around.begin(), around.end(), deltas.begin() + offsets[pattern],
+                       deltas.begin() + offsets[pattern + 1])) {
+            return static_cast<std::uint8_t>(pattern);
+        }
+    }
+    deltas.insert(deltas.end(), around.begin(), around.end());
+    offsets.push_back(static_cast<int>(deltas.size()));
+    return static_cast<std::uint8_t>(pattern_amount);
+}
+
+/**
+ * @brief Checks if two cells touch each other.
+ *
+ * @param cell Index of the first cell.
+ * @param other Index of the second cell.
+ * @return True if `other` is a neighbour of `cell`.
+ */
+
+bool Topology::are_neighbours(int cell, int other) const {
+    for (int neighbour : neighbours(cell)) {
+        if (neighbour == other) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Gets the shape of the board.
+ */
+
+Shape Topology::get_shape() const {
+    return shape;
+}
@@ -0,0 +1,78 @@
+/**
+ * @file topology.h
+ * @brief Class holding the precomputed neighbours of every cell of a board.
+ */
+
+#ifndef TOPOLOGY_H
+#define TOPOLOGY_H
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Shapes of the board offered for custom games.
+ */
+
+enum class Shape {
+    Rectangle,
+    Torus,
+    Hexagon
+};
+
+/**
+ * @class Topology
+ * @brief A class holding the adjacency table of a board in compressed sparse row form.
+ *
+ * @details Cells are indexed row by row (`row * width + column`). Most cells share the same neighbour
+ * offsets (all inner cells of a rectangle, for example), so the table stores every distinct list of
+ * offsets once, in compressed sparse rows, and a one byte pattern number per cell. The neighbours of
+ * cell `i` are `i + deltas[offsets[p]]` up to `i + deltas[offsets[p + 1]]` with `p = patterns[i]`,
+ * so walking them is a plain loop without bounds checks and the table of a large board stays in cache.
+ * The table is built once per board:
+ *  - `Rectangle` – up to 8 neighbours, cells at the edges have fewer.
+ *  - `Torus` – 8 neighbours, the edges wrap around to the opposite side.
+ *  - `Hexagon` – up to 6 neighbours, odd rows are shifted half a cell to the right.
+ */
+
+class Topology {
+public:
+    /**
+     * @brief Iterator turning the offsets of a pattern into neighbour indices.
+     */
+    struct Iterator {
+        const int* delta;
+        int cell;
+        int operator*() const { return cell + *delta; }
+        Iterator& operator++() { ++delta; return *this; }
+        bool operator!=(const Iterator& other) const { return delta != other.delta; }
+    };
+
+    /**
+     * @brief Range of neighbour indices usable in a range-based for loop.
+     */
+    struct Neighbours {
+        Iterator first;
+        Iterator last;
+        Iterator begin() const { return first; }
+        Iterator end() const { return last; }
+    };
+private:
+    int width;
+    int height;
+    Shape shape;
+    std::vector<std::uint8_t> patterns;
+    std::vector<int> offsets;
+    std::vector<int> deltas;
+    void add_neighbour(std::vector<int>& around, int cell, int row, int column) const;
+    std::uint8_t add_pattern(const std::vector<int>& around);
+public:
+    Topology(int w, int h, Shape s = Shape::Rectangle);
+    Neighbours neighbours(int cell) const {
+        const int pattern = patterns[cell];
+        return {{deltas.data() + offsets[pattern], cell}, {deltas.data() + offsets[pattern + 1], cell}};
+    }
+    bool are_neighbours(int cell, int other) const;
+    Shape get_shape() const;
+};
+
+#endif //TOPOLOGY_H